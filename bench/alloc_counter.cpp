@@ -0,0 +1,25 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "alloc_counter.h"
+using namespace std;
+
+static atomic<uint64_t> heap_allocs{0};
+
+uint64_t heap_allocations()
+{
+    return heap_allocs.load(memory_order_relaxed);
+}
+
+void *operator new(size_t bytes)
+{
+    heap_allocs.fetch_add(1, memory_order_relaxed);
+    if (void *p = malloc(bytes ? bytes : 1))
+        return p;
+    throw bad_alloc();
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void *operator new[](size_t bytes) { return operator new(bytes); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
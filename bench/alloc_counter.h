@@ -0,0 +1,6 @@
+#pragma once
+#include <cstdint>
+
+// Đếm cấp phát heap của cả chương trình (thay operator new / delete toàn cục)
+// Dùng chung cho dh_bench và tests/allocation_test; LimbArena không đi qua operator new nên không được tính.
+uint64_t heap_allocations();
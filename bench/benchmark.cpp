@@ -0,0 +1,203 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include "diffie_hellman.h"
+#include "dh_groups.h"
+#include "alloc_counter.h"
+using namespace std;
+
+// Benchmark các phép toán chính của BigInt theo số bit, xuất JSON để so sánh giữa các phiên bản
+//  - Dữ liệu vào sinh từ seed cố định (BigInt::seed_random) --> mọi lần chạy đo trên cùng các số
+//  - ns/op, ops/sec: chạy lặp theo lô gấp đôi đến khi đủ min_time
+//  - allocs/op: số lần cấp phát heap (operator new) trong vòng đo, không tính LimbArena
+// Cách dùng: dh_bench [--min-time ms] [--filter tên] [--max-prime-bits n] [--seed s] [--out file.json]
+
+struct Result
+{
+    string name;
+    size_t bits;
+    uint64_t iterations;
+    double ns_per_op;
+    double ops_per_sec;
+    double allocs_per_op;
+};
+
+struct Options
+{
+    double min_time_ms = 300;
+    string filter;
+    size_t max_prime_bits = 1024; // generate_safe_prime lớn hơn mất hàng phút
+    uint64_t seed = 20240101;
+    string out;
+};
+
+// Giữ kết quả lại để trình biên dịch không bỏ phép tính
+static volatile size_t sink;
+
+/*
+    @param op (Phép đo, gọi 1 lần = 1 op)
+    @logic
+    1. Chạy thử 1 lần (làm nóng cache, bảng lũy thừa 10^k, arena của thread)
+    2. Chạy theo lô 1, 2, 4, ... lần đến khi tổng thời gian >= min_time
+    3. Chia tổng thời gian và số lần cấp phát cho số lần lặp
+*/
+template <class F>
+static Result measure(const string &name, size_t bits, const Options &opt, F op)
+{
+    op();
+    uint64_t iterations = 0, batch = 1;
+    double elapsed_ns = 0;
+    uint64_t allocs_before = heap_allocations();
+    while (elapsed_ns < opt.min_time_ms * 1e6)
+    {
+        auto start = chrono::steady_clock::now();
+        for (uint64_t i = 0; i < batch; i++)
+            op();
+        elapsed_ns += chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        iterations += batch;
+        batch *= 2;
+    }
+    uint64_t allocs = heap_allocations() - allocs_before;
+    double ns = elapsed_ns / iterations;
+    return {name, bits, iterations, ns, 1e9 / ns, (double)allocs / iterations};
+}
+
+// Số nguyên tố bits bit cho Miller-Rabin (trường hợp chậm nhất: qua hết mọi vòng)
+static BigInt test_prime(size_t bits)
+{
+    if (const DHGroup *group = DHGroup::by_bits(bits))
+        return group->prime();
+    return BigInt::generate_prime((int)bits);
+}
+
+static string json_escape(const string &s)
+{
+    string out;
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\')
+            out.push_back('\\');
+        out.push_back(c);
+    }
+    return out;
+}
+
+static string to_json(const vector<Result> &results, const Options &opt)
+{
+    ostringstream os;
+    os << "{\n  \"version\": 1,\n  \"seed\": " << opt.seed << ",\n  \"min_time_ms\": " << opt.min_time_ms
+       << ",\n  \"compiler\": \"" << json_escape(__VERSION__) << "\",\n  \"results\": [";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const Result &r = results[i];
+        char line[256];
+        snprintf(line, sizeof(line),
+                 "%s\n    {\"name\": \"%s\", \"bits\": %zu, \"iterations\": %llu, \"ns_per_op\": %.1f, "
+                 "\"ops_per_sec\": %.3f, \"allocs_per_op\": %.2f}",
+                 i ? "," : "", r.name.c_str(), r.bits, (unsigned long long)r.iterations, r.ns_per_op,
+                 r.ops_per_sec, r.allocs_per_op);
+        os << line;
+    }
+    os << "\n  ]\n}\n";
+    return os.str();
+}
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            fprintf(stderr, "Missing value for %s\n", arg.c_str());
+            return 1;
+        }
+        if (arg == "--min-time")
+            opt.min_time_ms = atof(argv[++i]);
+        else if (arg == "--filter")
+            opt.filter = argv[++i];
+        else if (arg == "--max-prime-bits")
+            opt.max_prime_bits = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--seed")
+            opt.seed = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--out")
+            opt.out = argv[++i];
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            return 1;
+        }
+    }
+
+    vector<Result> results;
+    auto run = [&](const string &name, size_t bits, const function<void()> &op)
+    {
+        if (!opt.filter.empty() && name.find(opt.filter) == string::npos)
+            return;
+        // Seed lại trước mỗi phép đo: các số ngẫu nhiên bên trong (Miller-Rabin, sinh số nguyên tố) lặp lại được
+        BigInt::seed_random(opt.seed ^ (bits * 0x9E3779B97F4A7C15ULL));
+        results.push_back(measure(name, bits, opt, op));
+        const Result &r = results.back();
+        fprintf(stderr, "%-33s %5zu bit %14.0f ns/op %8.2f allocs/op\n", name.c_str(), bits, r.ns_per_op, r.allocs_per_op);
+    };
+
+    for (size_t bits : {512, 1024, 2048, 3072, 4096, 8192})
+    {
+        // Dữ liệu vào cố định theo (seed, bits)
+        BigInt::seed_random(opt.seed + bits);
+        BigInt a = BigInt::random_bits((int)bits), b = BigInt::random_bits((int)bits);
+        BigInt wide = BigInt::random_bits((int)(2 * bits) - 1); // < mod^2 cho Barrett
+        BigInt mod = BigInt::random_bits((int)bits);            // random_bits luôn lẻ --> đường Montgomery
+        BigInt base = a % mod, exp = BigInt::random_bits((int)bits);
+        BigInt prime = test_prime(bits);
+        BigInt peer = a % prime; // Khóa công khai giả định của bên kia
+        string dec = a.to_string();
+
+        run("karatsuba_multiply", bits, [&]
+            { sink = BigInt::karatsuba_multiply(a, b).bit_length(); });
+        run("barrett_mod", bits, [&]
+            { sink = BigInt::barrett_mod(wide, mod).bit_length(); });
+        run("operator/", bits, [&]
+            { sink = (wide / mod).bit_length(); });
+        run("modular_exponentiation", bits, [&]
+            { sink = BigInt::modular_exponentiation(base, exp, mod).bit_length(); });
+        run("modular_exponentiation_consttime", bits, [&]
+            { sink = BigInt::modular_exponentiation_consttime(base, exp, mod).bit_length(); });
+        run("validate_public_key", bits, [&]
+            { sink = BigInt::validate_public_key(peer, prime); });
+        run("is_prime_by_Miller_Rabin", bits, [&]
+            { sink = BigInt::is_prime_by_Miller_Rabin(prime); });
+        run("is_prime_by_Baillie_PSW", bits, [&]
+            { sink = BigInt::is_prime_by_Baillie_PSW(prime); });
+        if (bits <= opt.max_prime_bits)
+            run("generate_safe_prime", bits, [&]
+                { sink = BigInt::generate_safe_prime((int)bits).bit_length(); });
+        if (bits <= opt.max_prime_bits)
+            run("generate_safe_prime_bpsw", bits, [&]
+                { sink = BigInt::generate_safe_prime((int)bits, PrimalityTest::BAILLIE_PSW).bit_length(); });
+        run("decimal_format", bits, [&]
+            { sink = a.to_string().size(); });
+        run("decimal_parse", bits, [&]
+            { sink = BigInt(dec).bit_length(); });
+    }
+
+    // Bản dựng có DH_INSTRUMENT: in thêm bộ đếm / histogram của toàn bộ lần chạy
+    if (Instrumentation::enabled())
+        fputs(Instrumentation::to_text(Instrumentation::snapshot()).c_str(), stderr);
+
+    string json = to_json(results, opt);
+    if (opt.out.empty())
+    {
+        fputs(json.c_str(), stdout);
+    }
+    else
+    {
+        ofstream file(opt.out);
+        file << json;
+    }
+    return 0;
+}
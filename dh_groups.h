@@ -0,0 +1,782 @@
+#pragma once
+#include "diffie_hellman.h"
+
+// Các nhóm Diffie-Hellman chuẩn hóa dựng sẵn: MODP (RFC 3526) và ffdhe (RFC 7919), phần tử sinh g = 2
+// p là số nguyên tố an toàn b bit (b chia hết cho 64):
+//     RFC 3526: p = 2^b - 2^(b-64) - 1 + 2^64 * (floor(2^(b-130) * pi) + c)
+//     RFC 7919: như trên với e thay cho pi
+// Mỗi nhóm gồm các mảng constexpr k = b / 64 block 64 bit (block thấp trước), R = 2^b:
+//     _P: p, _R: R mod p (số 1 dạng Montgomery), _R2: R^2 mod p
+// -p^-1 mod 2^64 = 1 vì p ≡ -1 (mod 2^64).
+// --> lúc chạy không sinh số nguyên tố và không tính tham số nào (MontgomeryContext chỉ sao chép hằng số).
+
+// modp1536: RFC 3526 nhóm 5, 1536 bit
+constexpr uint64_t DH_MODP1536_P[24] = {
+    0xFFFFFFFFFFFFFFFF, 0xF1746C08CA237327, 0x670C354E4ABC9804, 0x9ED529077096966D,
+    0x1C62F356208552BB, 0x83655D23DCA3AD96, 0x69163FA8FD24CF5F, 0x98DA48361C55D39A,
+    0xC2007CB8A163BF05, 0x49286651ECE45B3D, 0xAE9F24117C4B1FE6, 0xEE386BFB5A899FA5,
+    0x0BFF5CB6F406B7ED, 0xF44C42E9A637ED6B, 0xE485B576625E7EC6, 0x4FE1356D6D51C245,
+    0x302B0A6DF25F1437, 0xEF9519B3CD3A431B, 0x514A08798E3404DD, 0x020BBEA63B139B22,
+    0x29024E088A67CC74, 0xC4C6628B80DC1CD1, 0xC90FDAA22168C234, 0xFFFFFFFFFFFFFFFF,
+};
+constexpr uint64_t DH_MODP1536_R[24] = {
+    0x0000000000000001, 0x0E8B93F735DC8CD8, 0x98F3CAB1B54367FB, 0x612AD6F88F696992,
+    0xE39D0CA9DF7AAD44, 0x7C9AA2DC235C5269, 0x96E9C05702DB30A0, 0x6725B7C9E3AA2C65,
+    0x3DFF83475E9C40FA, 0xB6D799AE131BA4C2, 0x5160DBEE83B4E019, 0x11C79404A576605A,
+    0xF400A3490BF94812, 0x0BB3BD1659C81294, 0x1B7A4A899DA18139, 0xB01ECA9292AE3DBA,
+    0xCFD4F5920DA0EBC8, 0x106AE64C32C5BCE4, 0xAEB5F78671CBFB22, 0xFDF44159C4EC64DD,
+    0xD6FDB1F77598338B, 0x3B399D747F23E32E, 0x36F0255DDE973DCB, 0x0000000000000000,
+};
+constexpr uint64_t DH_MODP1536_R2[24] = {
+    0xF115D27D32C695E0, 0x8E0E3E2167478C73, 0xD0AB92E18397F245, 0xF466EE5FBCD49D68,
+    0x8F2331B13B01E018, 0x7E8CD2AC98B5FB62, 0xB9052BB47A58F170, 0xB004A750DB102D39,
+    0x04A541FF93AE1CEB, 0x07CD0A628E434130, 0x1C729C7E04B9F796, 0xB8FE6121196B7E88,
+    0x8E1ABD780223B76B, 0x22C296E9D46FEC23, 0xD62A0EEAB270521B, 0xDC541A4ED4053F54,
+    0xF8056564969B7F02, 0x0BE49647A87C7B37, 0x57B5934867984460, 0x102630FA9A36A51F,
+    0xE9C3FA02CC2456EF, 0xAE5941047929A1C7, 0xEE9C9A216CC1EBD2, 0xE3B33C7259541C01,
+};
+
+// modp2048: RFC 3526 nhóm 14, 2048 bit
+constexpr uint64_t DH_MODP2048_P[32] = {
+    0xFFFFFFFFFFFFFFFF, 0x15728E5A8AACAA68, 0x15D2261898FA0510, 0x3995497CEA956AE5,
+    0xDE2BCBF695581718, 0xB5C55DF06F4C52C9, 0x9B2783A2EC07A28F, 0xE39E772C180E8603,
+    0x32905E462E36CE3B, 0xF1746C08CA18217C, 0x670C354E4ABC9804, 0x9ED529077096966D,
+    0x1C62F356208552BB, 0x83655D23DCA3AD96, 0x69163FA8FD24CF5F, 0x98DA48361C55D39A,
+    0xC2007CB8A163BF05, 0x49286651ECE45B3D, 0xAE9F24117C4B1FE6, 0xEE386BFB5A899FA5,
+    0x0BFF5CB6F406B7ED, 0xF44C42E9A637ED6B, 0xE485B576625E7EC6, 0x4FE1356D6D51C245,
+    0x302B0A6DF25F1437, 0xEF9519B3CD3A431B, 0x514A08798E3404DD, 0x020BBEA63B139B22,
+    0x29024E088A67CC74, 0xC4C6628B80DC1CD1, 0xC90FDAA22168C234, 0xFFFFFFFFFFFFFFFF,
+};
+constexpr uint64_t DH_MODP2048_R[32] = {
+    0x0000000000000001, 0xEA8D71A575535597, 0xEA2DD9E76705FAEF, 0xC66AB683156A951A,
+    0x21D434096AA7E8E7, 0x4A3AA20F90B3AD36, 0x64D87C5D13F85D70, 0x1C6188D3E7F179FC,
+    0xCD6FA1B9D1C931C4, 0x0E8B93F735E7DE83, 0x98F3CAB1B54367FB, 0x612AD6F88F696992,
+    0xE39D0CA9DF7AAD44, 0x7C9AA2DC235C5269, 0x96E9C05702DB30A0, 0x6725B7C9E3AA2C65,
+    0x3DFF83475E9C40FA, 0xB6D799AE131BA4C2, 0x5160DBEE83B4E019, 0x11C79404A576605A,
+    0xF400A3490BF94812, 0x0BB3BD1659C81294, 0x1B7A4A899DA18139, 0xB01ECA9292AE3DBA,
+    0xCFD4F5920DA0EBC8, 0x106AE64C32C5BCE4, 0xAEB5F78671CBFB22, 0xFDF44159C4EC64DD,
+    0xD6FDB1F77598338B, 0x3B399D747F23E32E, 0x36F0255DDE973DCB, 0x0000000000000000,
+};
+constexpr uint64_t DH_MODP2048_R2[32] = {
+    0x477122CE125FB664, 0xB03548FB9B38D313, 0x4C2153FF6FD412C1, 0x2A092B50873F9BC6,
+    0xBBC71629FCB7F5F9, 0x4BEC06E136BD84E7, 0x27BA725A6B020CB1, 0xF8115426ED939EEB,
+    0x4BC1B1878A0E30D9, 0x5620820E258633FF, 0x074ED6AB785A3071, 0xF228105F81F1CB61,
+    0x570E436F4E2E6F7F, 0x5CA52FF7D7450BD9, 0x552272D275F10A7E, 0xAC2B7925739C7978,
+    0xA2F88257325B54D0, 0xBC821C9DE8D72BD5, 0xDBD442B3866D2986, 0x9478951B70C4B2CE,
+    0x5D998FB394910C76, 0xF273B2937E300867, 0x8C106BBE38569F92, 0xF83C92CB14E992C5,
+    0xD85D6E7EED6880DD, 0xEB5B276FBE06A1DF, 0x2A492090FA11E105, 0x63BDD96D19EA00BE,
+    0x272382970A1698AB, 0x8A3A686C9240C974, 0x3ED8570366613000, 0x0CD37A33628B3197,
+};
+
+// modp3072: RFC 3526 nhóm 15, 3072 bit
+constexpr uint64_t DH_MODP3072_P[48] = {
+    0xFFFFFFFFFFFFFFFF, 0x4B82D120A93AD2CA, 0x43DB5BFCE0FD108E, 0x08E24FA074E5AB31,
+    0x770988C0BAD946E2, 0xBBE117577A615D6C, 0x521F2B18177B200C, 0xD87602733EC86A64,
+    0xF12FFA06D98A0864, 0xCEE3D2261AD2EE6B, 0x1E8C94E04A25619D, 0xABF5AE8CDB0933D7,
+    0xB3970F85A6E1E4C7, 0x8AEA71575D060C7D, 0xECFB850458DBEF0A, 0xA85521ABDF1CBA64,
+    0xAD33170D04507A33, 0x15728E5A8AAAC42D, 0x15D2261898FA0510, 0x3995497CEA956AE5,
+    0xDE2BCBF695581718, 0xB5C55DF06F4C52C9, 0x9B2783A2EC07A28F, 0xE39E772C180E8603,
+    0x32905E462E36CE3B, 0xF1746C08CA18217C, 0x670C354E4ABC9804, 0x9ED529077096966D,
+    0x1C62F356208552BB, 0x83655D23DCA3AD96, 0x69163FA8FD24CF5F, 0x98DA48361C55D39A,
+    0xC2007CB8A163BF05, 0x49286651ECE45B3D, 0xAE9F24117C4B1FE6, 0xEE386BFB5A899FA5,
+    0x0BFF5CB6F406B7ED, 0xF44C42E9A637ED6B, 0xE485B576625E7EC6, 0x4FE1356D6D51C245,
+    0x302B0A6DF25F1437, 0xEF9519B3CD3A431B, 0x514A08798E3404DD, 0x020BBEA63B139B22,
+    0x29024E088A67CC74, 0xC4C6628B80DC1CD1, 0xC90FDAA22168C234, 0xFFFFFFFFFFFFFFFF,
+};
+constexpr uint64_t DH_MODP3072_R[48] = {
+    0x0000000000000001, 0xB47D2EDF56C52D35, 0xBC24A4031F02EF71, 0xF71DB05F8B1A54CE,
+    0x88F6773F4526B91D, 0x441EE8A8859EA293, 0xADE0D4E7E884DFF3, 0x2789FD8CC137959B,
+    0x0ED005F92675F79B, 0x311C2DD9E52D1194, 0xE1736B1FB5DA9E62, 0x540A517324F6CC28,
+    0x4C68F07A591E1B38, 0x75158EA8A2F9F382, 0x13047AFBA72410F5, 0x57AADE5420E3459B,
+    0x52CCE8F2FBAF85CC, 0xEA8D71A575553BD2, 0xEA2DD9E76705FAEF, 0xC66AB683156A951A,
+    0x21D434096AA7E8E7, 0x4A3AA20F90B3AD36, 0x64D87C5D13F85D70, 0x1C6188D3E7F179FC,
+    0xCD6FA1B9D1C931C4, 0x0E8B93F735E7DE83, 0x98F3CAB1B54367FB, 0x612AD6F88F696992,
+    0xE39D0CA9DF7AAD44, 0x7C9AA2DC235C5269, 0x96E9C05702DB30A0, 0x6725B7C9E3AA2C65,
+    0x3DFF83475E9C40FA, 0xB6D799AE131BA4C2, 0x5160DBEE83B4E019, 0x11C79404A576605A,
+    0xF400A3490BF94812, 0x0BB3BD1659C81294, 0x1B7A4A899DA18139, 0xB01ECA9292AE3DBA,
+    0xCFD4F5920DA0EBC8, 0x106AE64C32C5BCE4, 0xAEB5F78671CBFB22, 0xFDF44159C4EC64DD,
+    0xD6FDB1F77598338B, 0x3B399D747F23E32E, 0x36F0255DDE973DCB, 0x0000000000000000,
+};
+constexpr uint64_t DH_MODP3072_R2[48] = {
+    0x2697CA9138D241CD, 0x3587F06960E7F138, 0x4F30B920E5C1DB66, 0x95823215B15BA577,
+    0x4335AACB64894D96, 0xAE1284023C6ED6A3, 0xFC1187A5FA8406AB, 0x682AAB9A15B17FFA,
+    0xBC2B64CF26E335D7, 0x8AA61391ABB0B76A, 0x1EF22571E41A52B2, 0x1D93075AA993D147,
+    0xFEA5187FA77DEDDA, 0xAF80D4B5443561C6, 0xB186424B83DF2859, 0x1CAEFC188A59BC7F,
+    0x1B9D01271D18F0C8, 0x3EFEF29DC3C0B3F4, 0x785483C608108C0C, 0x4F12768256E88B53,
+    0xBFD961D538D6FCDD, 0xB41A05F078024208, 0x19CC8D59563706FB, 0x5A7795D86ECC4987,
+    0x9A678BF4439F12EB, 0x7CDA502EC043F99C, 0x0672A33D61E37F74, 0x19C2883EEFC802AF,
+    0x7DED489E670D9C6F, 0xA73D01032C4B8E90, 0x8C6CBD34D5965134, 0x77A5C747D85B0A83,
+    0x109D099E16FD7568, 0xA5DAF736BC8D5E9E, 0x7139D0AB24B7E495, 0x49CD9D705DA184D5,
+    0x2276CB40571F2C1C, 0xAF0EC45CDC396086, 0xAA05DA05C27FDD33, 0x9875D4C167DB7EDC,
+    0x5CAA69009FBF543F, 0xFA022336F28DE772, 0xFAE1CD10648BEE54, 0x2AD479FE69695C75,
+    0x84895A7C5542F96C, 0xA332E8E3E0669E0F, 0x44C4E4E431AD0295, 0x5AC8B4FB51DF35DA,
+};
+
+// modp4096: RFC 3526 nhóm 16, 4096 bit
+constexpr uint64_t DH_MODP4096_P[64] = {
+    0xFFFFFFFFFFFFFFFF, 0x4DF435C934063199, 0x86FFB7DC90A6C08F, 0x93B4EA988D8FDDC1,
+    0xD0069127D5B05AA9, 0xB81BDD762170481C, 0x1F612970CEE2D7AF, 0x233BA186515BE7ED,
+    0x99B2964FA090C3A2, 0x287C59474E6BC05D, 0x2E8EFC141FBECAA6, 0xDBBBC2DB04DE8EF9,
+    0x2583E9CA2AD44CE8, 0x1A946834B6150BDA, 0x99C327186AF4E23C, 0x88719A10BDBA5B26,
+    0x1A723C12A787E6D7, 0x4B82D120A9210801, 0x43DB5BFCE0FD108E, 0x08E24FA074E5AB31,
+    0x770988C0BAD946E2, 0xBBE117577A615D6C, 0x521F2B18177B200C, 0xD87602733EC86A64,
+    0xF12FFA06D98A0864, 0xCEE3D2261AD2EE6B, 0x1E8C94E04A25619D, 0xABF5AE8CDB0933D7,
+    0xB3970F85A6E1E4C7, 0x8AEA71575D060C7D, 0xECFB850458DBEF0A, 0xA85521ABDF1CBA64,
+    0xAD33170D04507A33, 0x15728E5A8AAAC42D, 0x15D2261898FA0510, 0x3995497CEA956AE5,
+    0xDE2BCBF695581718, 0xB5C55DF06F4C52C9, 0x9B2783A2EC07A28F, 0xE39E772C180E8603,
+    0x32905E462E36CE3B, 0xF1746C08CA18217C, 0x670C354E4ABC9804, 0x9ED529077096966D,
+    0x1C62F356208552BB, 0x83655D23DCA3AD96, 0x69163FA8FD24CF5F, 0x98DA48361C55D39A,
+    0xC2007CB8A163BF05, 0x49286651ECE45B3D, 0xAE9F24117C4B1FE6, 0xEE386BFB5A899FA5,
+    0x0BFF5CB6F406B7ED, 0xF44C42E9A637ED6B, 0xE485B576625E7EC6, 0x4FE1356D6D51C245,
+    0x302B0A6DF25F1437, 0xEF9519B3CD3A431B, 0x514A08798E3404DD, 0x020BBEA63B139B22,
+    0x29024E088A67CC74, 0xC4C6628B80DC1CD1, 0xC90FDAA22168C234, 0xFFFFFFFFFFFFFFFF,
+};
+constexpr uint64_t DH_MODP4096_R[64] = {
+    0x0000000000000001, 0xB20BCA36CBF9CE66, 0x790048236F593F70, 0x6C4B15677270223E,
+    0x2FF96ED82A4FA556, 0x47E42289DE8FB7E3, 0xE09ED68F311D2850, 0xDCC45E79AEA41812,
+    0x664D69B05F6F3C5D, 0xD783A6B8B1943FA2, 0xD17103EBE0413559, 0x24443D24FB217106,
+    0xDA7C1635D52BB317, 0xE56B97CB49EAF425, 0x663CD8E7950B1DC3, 0x778E65EF4245A4D9,
+    0xE58DC3ED58781928, 0xB47D2EDF56DEF7FE, 0xBC24A4031F02EF71, 0xF71DB05F8B1A54CE,
+    0x88F6773F4526B91D, 0x441EE8A8859EA293, 0xADE0D4E7E884DFF3, 0x2789FD8CC137959B,
+    0x0ED005F92675F79B, 0x311C2DD9E52D1194, 0xE1736B1FB5DA9E62, 0x540A517324F6CC28,
+    0x4C68F07A591E1B38, 0x75158EA8A2F9F382, 0x13047AFBA72410F5, 0x57AADE5420E3459B,
+    0x52CCE8F2FBAF85CC, 0xEA8D71A575553BD2, 0xEA2DD9E76705FAEF, 0xC66AB683156A951A,
+    0x21D434096AA7E8E7, 0x4A3AA20F90B3AD36, 0x64D87C5D13F85D70, 0x1C6188D3E7F179FC,
+    0xCD6FA1B9D1C931C4, 0x0E8B93F735E7DE83, 0x98F3CAB1B54367FB, 0x612AD6F88F696992,
+    0xE39D0CA9DF7AAD44, 0x7C9AA2DC235C5269, 0x96E9C05702DB30A0, 0x6725B7C9E3AA2C65,
+    0x3DFF83475E9C40FA, 0xB6D799AE131BA4C2, 0x5160DBEE83B4E019, 0x11C79404A576605A,
+    0xF400A3490BF94812, 0x0BB3BD1659C81294, 0x1B7A4A899DA18139, 0xB01ECA9292AE3DBA,
+    0xCFD4F5920DA0EBC8, 0x106AE64C32C5BCE4, 0xAEB5F78671CBFB22, 0xFDF44159C4EC64DD,
+    0xD6FDB1F77598338B, 0x3B399D747F23E32E, 0x36F0255DDE973DCB, 0x0000000000000000,
+};
+constexpr uint64_t DH_MODP4096_R2[64] = {
+    0xC14AB0DDCC03AA20, 0x8A1AC024B30E9B12, 0xFA8F75F0067E82B1, 0x37BF90FE52074F19,
+    0x55EA6F7541C4F82B, 0xB850DE95D97AC40A, 0x3549C5777A17FB04, 0x2A434CEB230B2DFE,
+    0x524E7C7A7ED36C41, 0xE44040921C1E467C, 0xA796D18204A636F7, 0xC9C77F0C352D408C,
+    0x51E75D9998F001DB, 0x8267537D4A612A18, 0x912A04913E9EBD87, 0x2E52989ECCF85F34,
+    0xD203A9E0D7CE25D0, 0x53C44FAB734810F7, 0x20BD72B9B21E6B3D, 0x62D218771296EF6A,
+    0x8563215F72C8D989, 0x04BA044AEB4EEFD4, 0xAE01E0F363A9315D, 0x5F666146CB441F59,
+    0xE60C6EFDFFB7A9A9, 0x6C7951A523CEF785, 0x0995484320E739F4, 0xFDC65A269B51C1EF,
+    0xC93919D12A4B1A67, 0xB18A9EF150C8953A, 0x1D7D37A23FB8CF61, 0x46BDB7336E8452D9,
+    0x8BD70562DA60E392, 0x4F024193787A8278, 0xCA06DA91C2B3E7E2, 0x8FB4832EF827DE84,
+    0x7E2C75A58E25F142, 0x3472086990DACF1A, 0xE8105464E9F80A5F, 0xB616D6FA8BE2C91D,
+    0xF1D27D0B5C7DC9C2, 0x9E10FDE28E54806B, 0xE4FCCF1D638F4566, 0x6C09060D41058639,
+    0xC28A61D47411402D, 0x67DE8FA023864714, 0x91A4F5572929B90C, 0xBEACD46F3CDD1196,
+    0xA89D1DCD9D381CC5, 0xCB225176259E080F, 0x18C3DCE20188D84C, 0x91F30C52F798DA6A,
+    0x3AD36FD822C39F34, 0xFEA80D9A6EC9FCD3, 0xF3E56CC2BD9F048C, 0x70B56F527F6F604F,
+    0x5401EA4F3ED73A2F, 0x526A653A7A674BD5, 0x4C2DE67DAD47527E, 0xAA7FBD9562059F1F,
+    0xF8B11725339EBC93, 0xB7B768C89931D78D, 0xE65BCC3AB78FDAA9, 0x3DA97659E280DB0B,
+};
+
+// modp6144: RFC 3526 nhóm 17, 6144 bit
+constexpr uint64_t DH_MODP6144_P[96] = {
+    0xFFFFFFFFFFFFFFFF, 0xE694F91E6DCC4024, 0x12BF2D5B0B7474D6, 0x043E8F663F4860EE,
+    0x387FE8D76E3C0468, 0xDA56C9EC2EF29632, 0xEB19CCB1A313D55C, 0xF550AA3D8A1FBFF0,
+    0x06A1D58BB7C5DA76, 0xA79715EEF29BE328, 0x14CC5ED20F8037E0, 0xCC8F6D7EBF48E1D8,
+    0x4BD407B22B4154AA, 0x0F1D45B7FF585AC5, 0x23A97A7E36CC88BE, 0x59E7C97FBEC7E8F3,
+    0xB5A84031900B1C9E, 0xD55E702F46980C82, 0xF482D7CE6E74FEF6, 0xF032EA15D1721D03,
+    0x5983CA01C64B92EC, 0x6FB8F401378CD2BF, 0x332051512BD7AF42, 0xDB7F1447E6CC254B,
+    0x44CE6CBACED4BB1B, 0xDA3EDBEBCF9B14ED, 0x179727B0865A8918, 0xB06A53ED9027D831,
+    0xE5DB382F413001AE, 0xF8FF9406AD9E530E, 0xC9751E763DBA37BD, 0xC1D4DCB2602646DE,
+    0x36C3FAB4D27C7026, 0x4DF435C934028492, 0x86FFB7DC90A6C08F, 0x93B4EA988D8FDDC1,
+    0xD0069127D5B05AA9, 0xB81BDD762170481C, 0x1F612970CEE2D7AF, 0x233BA186515BE7ED,
+    0x99B2964FA090C3A2, 0x287C59474E6BC05D, 0x2E8EFC141FBECAA6, 0xDBBBC2DB04DE8EF9,
+    0x2583E9CA2AD44CE8, 0x1A946834B6150BDA, 0x99C327186AF4E23C, 0x88719A10BDBA5B26,
+    0x1A723C12A787E6D7, 0x4B82D120A9210801, 0x43DB5BFCE0FD108E, 0x08E24FA074E5AB31,
+    0x770988C0BAD946E2, 0xBBE117577A615D6C, 0x521F2B18177B200C, 0xD87602733EC86A64,
+    0xF12FFA06D98A0864, 0xCEE3D2261AD2EE6B, 0x1E8C94E04A25619D, 0xABF5AE8CDB0933D7,
+    0xB3970F85A6E1E4C7, 0x8AEA71575D060C7D, 0xECFB850458DBEF0A, 0xA85521ABDF1CBA64,
+    0xAD33170D04507A33, 0x15728E5A8AAAC42D, 0x15D2261898FA0510, 0x3995497CEA956AE5,
+    0xDE2BCBF695581718, 0xB5C55DF06F4C52C9, 0x9B2783A2EC07A28F, 0xE39E772C180E8603,
+    0x32905E462E36CE3B, 0xF1746C08CA18217C, 0x670C354E4ABC9804, 0x9ED529077096966D,
+    0x1C62F356208552BB, 0x83655D23DCA3AD96, 0x69163FA8FD24CF5F, 0x98DA48361C55D39A,
+    0xC2007CB8A163BF05, 0x49286651ECE45B3D, 0xAE9F24117C4B1FE6, 0xEE386BFB5A899FA5,
+    0x0BFF5CB6F406B7ED, 0xF44C42E9A637ED6B, 0xE485B576625E7EC6, 0x4FE1356D6D51C245,
+    0x302B0A6DF25F1437, 0xEF9519B3CD3A431B, 0x514A08798E3404DD, 0x020BBEA63B139B22,
+    0x29024E088A67CC74, 0xC4C6628B80DC1CD1, 0xC90FDAA22168C234, 0xFFFFFFFFFFFFFFFF,
+};
+constexpr uint64_t DH_MODP6144_R[96] = {
+    0x0000000000000001, 0x196B06E19233BFDB, 0xED40D2A4F48B8B29, 0xFBC17099C0B79F11,
+    0xC780172891C3FB97, 0x25A93613D10D69CD, 0x14E6334E5CEC2AA3, 0x0AAF55C275E0400F,
+    0xF95E2A74483A2589, 0x5868EA110D641CD7, 0xEB33A12DF07FC81F, 0x3370928140B71E27,
+    0xB42BF84DD4BEAB55, 0xF0E2BA4800A7A53A, 0xDC568581C9337741, 0xA61836804138170C,
+    0x4A57BFCE6FF4E361, 0x2AA18FD0B967F37D, 0x0B7D2831918B0109, 0x0FCD15EA2E8DE2FC,
+    0xA67C35FE39B46D13, 0x90470BFEC8732D40, 0xCCDFAEAED42850BD, 0x2480EBB81933DAB4,
+    0xBB319345312B44E4, 0x25C124143064EB12, 0xE868D84F79A576E7, 0x4F95AC126FD827CE,
+    0x1A24C7D0BECFFE51, 0x07006BF95261ACF1, 0x368AE189C245C842, 0x3E2B234D9FD9B921,
+    0xC93C054B2D838FD9, 0xB20BCA36CBFD7B6D, 0x790048236F593F70, 0x6C4B15677270223E,
+    0x2FF96ED82A4FA556, 0x47E42289DE8FB7E3, 0xE09ED68F311D2850, 0xDCC45E79AEA41812,
+    0x664D69B05F6F3C5D, 0xD783A6B8B1943FA2, 0xD17103EBE0413559, 0x24443D24FB217106,
+    0xDA7C1635D52BB317, 0xE56B97CB49EAF425, 0x663CD8E7950B1DC3, 0x778E65EF4245A4D9,
+    0xE58DC3ED58781928, 0xB47D2EDF56DEF7FE, 0xBC24A4031F02EF71, 0xF71DB05F8B1A54CE,
+    0x88F6773F4526B91D, 0x441EE8A8859EA293, 0xADE0D4E7E884DFF3, 0x2789FD8CC137959B,
+    0x0ED005F92675F79B, 0x311C2DD9E52D1194, 0xE1736B1FB5DA9E62, 0x540A517324F6CC28,
+    0x4C68F07A591E1B38, 0x75158EA8A2F9F382, 0x13047AFBA72410F5, 0x57AADE5420E3459B,
+    0x52CCE8F2FBAF85CC, 0xEA8D71A575553BD2, 0xEA2DD9E76705FAEF, 0xC66AB683156A951A,
+    0x21D434096AA7E8E7, 0x4A3AA20F90B3AD36, 0x64D87C5D13F85D70, 0x1C6188D3E7F179FC,
+    0xCD6FA1B9D1C931C4, 0x0E8B93F735E7DE83, 0x98F3CAB1B54367FB, 0x612AD6F88F696992,
+    0xE39D0CA9DF7AAD44, 0x7C9AA2DC235C5269, 0x96E9C05702DB30A0, 0x6725B7C9E3AA2C65,
+    0x3DFF83475E9C40FA, 0xB6D799AE131BA4C2, 0x5160DBEE83B4E019, 0x11C79404A576605A,
+    0xF400A3490BF94812, 0x0BB3BD1659C81294, 0x1B7A4A899DA18139, 0xB01ECA9292AE3DBA,
+    0xCFD4F5920DA0EBC8, 0x106AE64C32C5BCE4, 0xAEB5F78671CBFB22, 0xFDF44159C4EC64DD,
+    0xD6FDB1F77598338B, 0x3B399D747F23E32E, 0x36F0255DDE973DCB, 0x0000000000000000,
+};
+constexpr uint64_t DH_MODP6144_R2[96] = {
+    0xF2E5D7F92769CCEF, 0xD79CB4FBF779F1D7, 0xA6631C495C857C44, 0x6B65A12FCA8CCF70,
+    0x9C9F091244F895B1, 0x90DF6DE3E31B0883, 0x7A8B8DF526956928, 0x3F7200E6D1FB45F8,
+    0x3A9ED507EDB5FCEF, 0xAADD0847CA9CC62E, 0x871D2A16360BB3AA, 0x1530396EC78AFFF1,
+    0x1F5032B378ED3113, 0x203255CF9524B491, 0x520AB2F9FEA1CE98, 0x90D70C830D11F9E1,
+    0x48458CA3EA5E3F5B, 0x52898788CD77C41D, 0x72DFC9B961B0C842, 0x55735A46FC876F3A,
+    0xF203B1CD2F58F862, 0x43825D57AEFC88F5, 0x33194926DFA1F968, 0xF173D56C480C6BAB,
+    0xE194DB6B5D833790, 0x918A0B68FCA30309, 0x3F253255E183A5F7, 0x3064BA2A6A133D72,
+    0xCC5485B7B12E8CC1, 0x1D4F7653F5BA0D9F, 0xBA9FCB1F2DA41854, 0x49640D7EF4C40DE7,
+    0x86047BA04499923F, 0x9BD9DF88C2D454F0, 0x2318A02BF2F63C8C, 0x3999D6F392F5201D,
+    0x67A7DC933AF22BB9, 0x893A8425B0996920, 0x78A15B8B2FF3AD59, 0x13C16BF586C04A2F,
+    0x5280FA416B810719, 0x5E8F534F4F5E5EF7, 0xD4C7B67721813571, 0x40F0BB5AE94C5902,
+    0x95EDB250C1126CE3, 0xCEBDBCC2AE5670AD, 0x0FA99AB5C58A142F, 0x59020C10353D298D,
+    0xC6C77B5E0945C0D2, 0x74ACAF8C2FFD3DAC, 0x8DC9886DB7831016, 0xC9639AD52628FBDE,
+    0xDFA7F4B0EA1ED3DF, 0xCE4F5E4113B2F0C9, 0xB2DFF8A940CAD1D7, 0xBDDBE63B061704AA,
+    0xF6DBB64E9386EA2C, 0xD1E9CC87E200C511, 0x7109EFE6C727E643, 0xF47C7C2511D45315,
+    0xCC78A407AF3A20CA, 0x93B60D5C11A0B718, 0xB10C758F391D270F, 0xD8680AF342650827,
+    0x22E9C31CAE7ADFB3, 0x7BD1CA13D63775FA, 0x2D575490E573FB06, 0xB24AB16E596687C8,
+    0xFA89D518CEB17174, 0x507FCA2B2E186829, 0x3C11BA15D4A6D48E, 0x324C05216FEAE732,
+    0x17408793C9EA4C96, 0xC0AC05F3D4C7B04E, 0x0EF4A3420B009204, 0x1616A8AD151796B4,
+    0x428C43FDE048F370, 0x09D459A2CF1D5CE6, 0x73E3C6D8114FA636, 0x93F1D144598E6059,
+    0x081AF9A8C29CA69E, 0xE3CE35AB350CC8CF, 0x220AAD79E1117774, 0xC1CA84156EACBA47,
+    0x59EF90068EE16F13, 0xD6635868E4C6DF9A, 0x857A38D56C902715, 0x6FD39D365D9326F8,
+    0x5A3A36B299D5FF38, 0xE3A0B97C07A114F0, 0x2E425E12D30C535F, 0xAA777857433AAD73,
+    0x34B6CA18CD30AB40, 0x71A2019823575F11, 0x3BE9FE85B730A23A, 0x1BDB24723A79D28C,
+};
+
+// modp8192: RFC 3526 nhóm 18, 8192 bit
+constexpr uint64_t DH_MODP8192_P[128] = {
+    0xFFFFFFFFFFFFFFFF, 0x60C980DD98EDD3DF, 0xC81F56E880B96E71, 0x9E3050E2765694DF,
+    0x9558E4475677E9AA, 0xC9190DA6FC026E47, 0x889A002ED5EE382B, 0x4009438B481C6CD7,
+    0x359046F4EB879F92, 0xFAF36BC31ECFA268, 0xB1D510BD7EE74D73, 0xF9AB48195DED7EA1,
+    0x64F31CC50846851D, 0x4597E899A0255DC1, 0xDF310EE074AB6A36, 0x6D2A13F83F44F82D,
+    0x062B3CF5B3A278A6, 0x79683303ED5BDD3A, 0xFA9D4B7FA2C087E8, 0x4BCBC8862F8385DD,
+    0x3473FC646CEA306B, 0x13EB57A81A23F0C7, 0x22222E04A4037C07, 0xE3FDB8BEFC848AD9,
+    0x238F16CBE39D652D, 0x3423B4742BF1C978, 0x3AAB639C5AE4F568, 0x2576F6936BA42466,
+    0x741FA7BF8AFC47ED, 0x3BC832B68D9DD300, 0xD8BEC4D073B931BA, 0x38777CB6A932DF8C,
+    0x74A3926F12FEE5E4, 0xE694F91E6DBE1159, 0x12BF2D5B0B7474D6, 0x043E8F663F4860EE,
+    0x387FE8D76E3C0468, 0xDA56C9EC2EF29632, 0xEB19CCB1A313D55C, 0xF550AA3D8A1FBFF0,
+    0x06A1D58BB7C5DA76, 0xA79715EEF29BE328, 0x14CC5ED20F8037E0, 0xCC8F6D7EBF48E1D8,
+    0x4BD407B22B4154AA, 0x0F1D45B7FF585AC5, 0x23A97A7E36CC88BE, 0x59E7C97FBEC7E8F3,
+    0xB5A84031900B1C9E, 0xD55E702F46980C82, 0xF482D7CE6E74FEF6, 0xF032EA15D1721D03,
+    0x5983CA01C64B92EC, 0x6FB8F401378CD2BF, 0x332051512BD7AF42, 0xDB7F1447E6CC254B,
+    0x44CE6CBACED4BB1B, 0xDA3EDBEBCF9B14ED, 0x179727B0865A8918, 0xB06A53ED9027D831,
+    0xE5DB382F413001AE, 0xF8FF9406AD9E530E, 0xC9751E763DBA37BD, 0xC1D4DCB2602646DE,
+    0x36C3FAB4D27C7026, 0x4DF435C934028492, 0x86FFB7DC90A6C08F, 0x93B4EA988D8FDDC1,
+    0xD0069127D5B05AA9, 0xB81BDD762170481C, 0x1F612970CEE2D7AF, 0x233BA186515BE7ED,
+    0x99B2964FA090C3A2, 0x287C59474E6BC05D, 0x2E8EFC141FBECAA6, 0xDBBBC2DB04DE8EF9,
+    0x2583E9CA2AD44CE8, 0x1A946834B6150BDA, 0x99C327186AF4E23C, 0x88719A10BDBA5B26,
+    0x1A723C12A787E6D7, 0x4B82D120A9210801, 0x43DB5BFCE0FD108E, 0x08E24FA074E5AB31,
+    0x770988C0BAD946E2, 0xBBE117577A615D6C, 0x521F2B18177B200C, 0xD87602733EC86A64,
+    0xF12FFA06D98A0864, 0xCEE3D2261AD2EE6B, 0x1E8C94E04A25619D, 0xABF5AE8CDB0933D7,
+    0xB3970F85A6E1E4C7, 0x8AEA71575D060C7D, 0xECFB850458DBEF0A, 0xA85521ABDF1CBA64,
+    0xAD33170D04507A33, 0x15728E5A8AAAC42D, 0x15D2261898FA0510, 0x3995497CEA956AE5,
+    0xDE2BCBF695581718, 0xB5C55DF06F4C52C9, 0x9B2783A2EC07A28F, 0xE39E772C180E8603,
+    0x32905E462E36CE3B, 0xF1746C08CA18217C, 0x670C354E4ABC9804, 0x9ED529077096966D,
+    0x1C62F356208552BB, 0x83655D23DCA3AD96, 0x69163FA8FD24CF5F, 0x98DA48361C55D39A,
+    0xC2007CB8A163BF05, 0x49286651ECE45B3D, 0xAE9F24117C4B1FE6, 0xEE386BFB5A899FA5,
+    0x0BFF5CB6F406B7ED, 0xF44C42E9A637ED6B, 0xE485B576625E7EC6, 0x4FE1356D6D51C245,
+    0x302B0A6DF25F1437, 0xEF9519B3CD3A431B, 0x514A08798E3404DD, 0x020BBEA63B139B22,
+    0x29024E088A67CC74, 0xC4C6628B80DC1CD1, 0xC90FDAA22168C234, 0xFFFFFFFFFFFFFFFF,
+};
+constexpr uint64_t DH_MODP8192_R[128] = {
+    0x0000000000000001, 0x9F367F2267122C20, 0x37E0A9177F46918E, 0x61CFAF1D89A96B20,
+    0x6AA71BB8A9881655, 0x36E6F25903FD91B8, 0x7765FFD12A11C7D4, 0xBFF6BC74B7E39328,
+    0xCA6FB90B1478606D, 0x050C943CE1305D97, 0x4E2AEF428118B28C, 0x0654B7E6A212815E,
+    0x9B0CE33AF7B97AE2, 0xBA6817665FDAA23E, 0x20CEF11F8B5495C9, 0x92D5EC07C0BB07D2,
+    0xF9D4C30A4C5D8759, 0x8697CCFC12A422C5, 0x0562B4805D3F7817, 0xB4343779D07C7A22,
+    0xCB8C039B9315CF94, 0xEC14A857E5DC0F38, 0xDDDDD1FB5BFC83F8, 0x1C024741037B7526,
+    0xDC70E9341C629AD2, 0xCBDC4B8BD40E3687, 0xC5549C63A51B0A97, 0xDA89096C945BDB99,
+    0x8BE058407503B812, 0xC437CD4972622CFF, 0x27413B2F8C46CE45, 0xC788834956CD2073,
+    0x8B5C6D90ED011A1B, 0x196B06E19241EEA6, 0xED40D2A4F48B8B29, 0xFBC17099C0B79F11,
+    0xC780172891C3FB97, 0x25A93613D10D69CD, 0x14E6334E5CEC2AA3, 0x0AAF55C275E0400F,
+    0xF95E2A74483A2589, 0x5868EA110D641CD7, 0xEB33A12DF07FC81F, 0x3370928140B71E27,
+    0xB42BF84DD4BEAB55, 0xF0E2BA4800A7A53A, 0xDC568581C9337741, 0xA61836804138170C,
+    0x4A57BFCE6FF4E361, 0x2AA18FD0B967F37D, 0x0B7D2831918B0109, 0x0FCD15EA2E8DE2FC,
+    0xA67C35FE39B46D13, 0x90470BFEC8732D40, 0xCCDFAEAED42850BD, 0x2480EBB81933DAB4,
+    0xBB319345312B44E4, 0x25C124143064EB12, 0xE868D84F79A576E7, 0x4F95AC126FD827CE,
+    0x1A24C7D0BECFFE51, 0x07006BF95261ACF1, 0x368AE189C245C842, 0x3E2B234D9FD9B921,
+    0xC93C054B2D838FD9, 0xB20BCA36CBFD7B6D, 0x790048236F593F70, 0x6C4B15677270223E,
+    0x2FF96ED82A4FA556, 0x47E42289DE8FB7E3, 0xE09ED68F311D2850, 0xDCC45E79AEA41812,
+    0x664D69B05F6F3C5D, 0xD783A6B8B1943FA2, 0xD17103EBE0413559, 0x24443D24FB217106,
+    0xDA7C1635D52BB317, 0xE56B97CB49EAF425, 0x663CD8E7950B1DC3, 0x778E65EF4245A4D9,
+    0xE58DC3ED58781928, 0xB47D2EDF56DEF7FE, 0xBC24A4031F02EF71, 0xF71DB05F8B1A54CE,
+    0x88F6773F4526B91D, 0x441EE8A8859EA293, 0xADE0D4E7E884DFF3, 0x2789FD8CC137959B,
+    0x0ED005F92675F79B, 0x311C2DD9E52D1194, 0xE1736B1FB5DA9E62, 0x540A517324F6CC28,
+    0x4C68F07A591E1B38, 0x75158EA8A2F9F382, 0x13047AFBA72410F5, 0x57AADE5420E3459B,
+    0x52CCE8F2FBAF85CC, 0xEA8D71A575553BD2, 0xEA2DD9E76705FAEF, 0xC66AB683156A951A,
+    0x21D434096AA7E8E7, 0x4A3AA20F90B3AD36, 0x64D87C5D13F85D70, 0x1C6188D3E7F179FC,
+    0xCD6FA1B9D1C931C4, 0x0E8B93F735E7DE83, 0x98F3CAB1B54367FB, 0x612AD6F88F696992,
+    0xE39D0CA9DF7AAD44, 0x7C9AA2DC235C5269, 0x96E9C05702DB30A0, 0x6725B7C9E3AA2C65,
+    0x3DFF83475E9C40FA, 0xB6D799AE131BA4C2, 0x5160DBEE83B4E019, 0x11C79404A576605A,
+    0xF400A3490BF94812, 0x0BB3BD1659C81294, 0x1B7A4A899DA18139, 0xB01ECA9292AE3DBA,
+    0xCFD4F5920DA0EBC8, 0x106AE64C32C5BCE4, 0xAEB5F78671CBFB22, 0xFDF44159C4EC64DD,
+    0xD6FDB1F77598338B, 0x3B399D747F23E32E, 0x36F0255DDE973DCB, 0x0000000000000000,
+};
+constexpr uint64_t DH_MODP8192_R2[128] = {
+    0x089AFC52A9CAFEE8, 0x21C090D25E13960F, 0x811C7FD755A928F1, 0xFE05C9F188E786C2,
+    0xA009B6312F6C2350, 0xF0A0E25B2A3A14F3, 0x7A20A52CB063AD98, 0xD7FF434FF4926560,
+    0x9232F9FD500FEDC5, 0x7D97D4C4318F22E7, 0xAFA4CA86547D057B, 0xF28F5477C086521E,
+    0x26E1AE2D49A52E3F, 0xF8E0F27E32F7CAB7, 0xD68C1FBC17304E6F, 0xC5D051C4F659129F,
+    0x890DF13078A415BE, 0x5F0D557D21C079AA, 0x370BC4A2CDEA6A14, 0x411CE8149160809D,
+    0xF2CC7FA94B8F23CA, 0x25E8A7A9181910C0, 0x86E7B98386CCB443, 0xE3922D994BEC4527,
+    0x2D71541A00732DC5, 0x8A9BBA0C31DD9D27, 0x5FEB690F7058D913, 0x04039857B28939F6,
+    0x587B56B730464B28, 0x784ECBA502AB7B0C, 0x4752185F9A9BF03A, 0xE23851A7D6A8720A,
+    0x2A384F7C1010186A, 0xE36F752B916BD432, 0x851C4B6C830AE8C3, 0x34A063B901532657,
+    0x71FAC862B3B8813D, 0x9ECE3FF216A22743, 0x5F600782503C2EEC, 0xBF60DF700A08C5FF,
+    0xE4888520D60D3434, 0x667064B0F5C564C3, 0xCD622A640643986E, 0x81D1A6ABC08E41A1,
+    0x4230458AA6544706, 0xDAB46B50116BBAC4, 0x465F635732886872, 0x85AFE39930F5B7FA,
+    0x7C46EF974D010C90, 0xC76637B4F719BD82, 0x2699D48DFADA8A6D, 0xFA623E65D445A3AD,
+    0xBDD0DF2507FEF8D0, 0xDB6B19DA34C8A497, 0xCE805B29A2E2D6E9, 0xDB0EAE6815280FD6,
+    0xCCDAEBD44AFED46E, 0x37F24C5CB4E4A5AC, 0x084326C7659BF93F, 0x5D6E12FBDBA7036A,
+    0x49C2DFDC7701464D, 0x97ED23C956112DAB, 0x2799372D282F2DB1, 0x8275F30D0D04B703,
+    0x2880692070CDAE86, 0xC6D4D33F4FAEB66C, 0xF12114360D327F15, 0xCA936AF4725F0D47,
+    0x9FCD1161086C11FF, 0x86056CC40FBBC443, 0x5691A81473D8A615, 0xF556394414AAA668,
+    0xD8BD35369CD1D286, 0x3A877FC42FA1B2D7, 0x3E65701CB44478E0, 0xC95246094B318FFB,
+    0xC06955DF9B15D7C1, 0xBE9748DD7B857FB7, 0x051CA44EBE1C6CA1, 0xC8460FB0B8A8D9D0,
+    0x19FA98CFE7FF4CDE, 0x4AFD2146859426B2, 0x27992869DD0DBB1D, 0x01500B714FB8B29A,
+    0x0B13A2F41F7F7ED6, 0x95FBF7C07173AE50, 0xB8FBEAA1233E2522, 0x31DF706D0CE48E20,
+    0xB74E1A92002E1F01, 0x13D99EA02D4DBC93, 0x34E40FB8E306371E, 0x666B5E042D32964F,
+    0xB56EAFCF4B8A1C87, 0xEE5F8E383E99BB13, 0x955B00C24B8E239D, 0x59687CA07D2B6A60,
+    0xF6BBAD5349674386, 0x2E32C13EB870DDBA, 0x8F7AFB0C795A5CDB, 0xAC2653332839E62F,
+    0xE30EC96D720C3D0F, 0x0287B953ABAE39D0, 0xAE673DB7C9CD44D5, 0xB6B11D9AA19BCA87,
+    0x4DBE19E79DDCA0FB, 0x9350AF30B28FED61, 0x73BA3A6C1D917D22, 0x48616A554F777C61,
+    0x23A567C56E31446E, 0xCE05A847F71229BF, 0x29C1106EFEAC640A, 0xAECA66BFC9712877,
+    0x172B176E1938F7E9, 0x6A874B1F32FCC609, 0x2C7747FC1FD567A4, 0x45E879B22FF780C7,
+    0xE0838C366A1529D8, 0x527983233DAB0B78, 0xAE679847791B0476, 0xCCF3682A865D28B1,
+    0x90BB82D93E222108, 0xD2FFCBA7F988E49E, 0x53F292F6783E7D7E, 0xF0675997ACE4A1D2,
+    0x7244D80046F0E30A, 0x413EED4FDE6C407D, 0xE4CBDA86C3B86684, 0x16D2E4AA7433FD52,
+};
+
+// ffdhe2048: RFC 7919, 2048 bit
+constexpr uint64_t DH_FFDHE2048_P[32] = {
+    0xFFFFFFFFFFFFFFFF, 0x886B423861285C97, 0xC6F34A26C1B2EFFA, 0xC58EF1837D1683B2,
+    0x3BB5FCBC2EC22005, 0xC3FE3B1B4C6FAD73, 0x8E4F1232EEF28183, 0x9172FE9CE98583FF,
+    0xC03404CD28342F61, 0x9E02FCE1CDF7E2EC, 0x0B07A7C8EE0A6D70, 0xAE56EDE76372BB19,
+    0x1D4F42A3DE394DF4, 0xB96ADAB760D7F468, 0xD108A94BB2C8E3FB, 0xBC0AB182B324FB61,
+    0x30ACCA4F483A797A, 0x1DF158A136ADE735, 0xE2A689DAF3EFE872, 0x984F0C70E0E68B77,
+    0xB557135E7F57C935, 0x856365553DED1AF3, 0x2433F51F5F066ED0, 0xD3DF1ED5D5FD6561,
+    0xF681B202AEC4617A, 0x7D2FE363630C75D8, 0xCC939DCE249B3EF9, 0xA9E13641146433FB,
+    0xD8B9C583CE2D3695, 0xAFDC5620273D3CF1, 0xADF85458A2BB4A9A, 0xFFFFFFFFFFFFFFFF,
+};
+constexpr uint64_t DH_FFDHE2048_R[32] = {
+    0x0000000000000001, 0x7794BDC79ED7A368, 0x390CB5D93E4D1005, 0x3A710E7C82E97C4D,
+    0xC44A0343D13DDFFA, 0x3C01C4E4B390528C, 0x71B0EDCD110D7E7C, 0x6E8D0163167A7C00,
+    0x3FCBFB32D7CBD09E, 0x61FD031E32081D13, 0xF4F8583711F5928F, 0x51A912189C8D44E6,
+    0xE2B0BD5C21C6B20B, 0x469525489F280B97, 0x2EF756B44D371C04, 0x43F54E7D4CDB049E,
+    0xCF5335B0B7C58685, 0xE20EA75EC95218CA, 0x1D5976250C10178D, 0x67B0F38F1F197488,
+    0x4AA8ECA180A836CA, 0x7A9C9AAAC212E50C, 0xDBCC0AE0A0F9912F, 0x2C20E12A2A029A9E,
+    0x097E4DFD513B9E85, 0x82D01C9C9CF38A27, 0x336C6231DB64C106, 0x561EC9BEEB9BCC04,
+    0x27463A7C31D2C96A, 0x5023A9DFD8C2C30E, 0x5207ABA75D44B565, 0x0000000000000000,
+};
+constexpr uint64_t DH_FFDHE2048_R2[32] = {
+    0x187BE36BD38A4FA1, 0x0A152F396458F3B8, 0x0570187EC422EEB7, 0x18AF748291173F2A,
+    0xE9FDAC6ACFF4EAAA, 0xF6AFEBB76E589D6C, 0xF92F8E9AB7E33FB0, 0x70ACF2AA4CF36DDD,
+    0x561AB426D07137FD, 0x5F57D037430EE91E, 0xE3E768C860D10B8A, 0xB14884D8A18AF8CE,
+    0xF8A98014A12B74E4, 0x748D407C3437B7A8, 0x627588C49875D5A7, 0xDD24A12753C8F09D,
+    0x85A997D50CD51AEC, 0x44F0C619CE348458, 0x9B894B245F6B69A1, 0xAE1302F2F6D4777E,
+    0xE6678EEB375DB18E, 0x2674E1D64FBCBDC8, 0xB297A8236FA93D28, 0x6A12FB707C8C0510,
+    0x5C6D1AEBDB06F65B, 0xE8C2954E4C1804CA, 0x06BDEAC1F5500FA7, 0x6A315604189CD76B,
+    0xBAE7B0B36E362DC0, 0xA57C73BDDC70FB82, 0xFAFF50D29D573457, 0x352BD399BE84058E,
+};
+
+// ffdhe3072: RFC 7919, 3072 bit
+constexpr uint64_t DH_FFDHE3072_P[48] = {
+    0xFFFFFFFFFFFFFFFF, 0x25E41D2B66C62E37, 0x3C1B20EE3FD59D7C, 0x0ABCD06BFA53DDEF,
+    0x1DBF9A42D5C4484E, 0xABC521979B0DEADA, 0xE86D2BC522363A0D, 0x5CAE82AB9C9DF69E,
+    0x64F2E21E71F54BFF, 0xF4FD4452E2D74DD3, 0xB4130C93BC437944, 0xAEFE130985139270,
+    0x598CB0FAC186D91C, 0x7AD91D2691F7F7EE, 0x61B46FC9D6E6C907, 0xBC34F4DEF99C0238,
+    0xDE355B3B6519035B, 0x886B4238611FCFDC, 0xC6F34A26C1B2EFFA, 0xC58EF1837D1683B2,
+    0x3BB5FCBC2EC22005, 0xC3FE3B1B4C6FAD73, 0x8E4F1232EEF28183, 0x9172FE9CE98583FF,
+    0xC03404CD28342F61, 0x9E02FCE1CDF7E2EC, 0x0B07A7C8EE0A6D70, 0xAE56EDE76372BB19,
+    0x1D4F42A3DE394DF4, 0xB96ADAB760D7F468, 0xD108A94BB2C8E3FB, 0xBC0AB182B324FB61,
+    0x30ACCA4F483A797A, 0x1DF158A136ADE735, 0xE2A689DAF3EFE872, 0x984F0C70E0E68B77,
+    0xB557135E7F57C935, 0x856365553DED1AF3, 0x2433F51F5F066ED0, 0xD3DF1ED5D5FD6561,
+    0xF681B202AEC4617A, 0x7D2FE363630C75D8, 0xCC939DCE249B3EF9, 0xA9E13641146433FB,
+    0xD8B9C583CE2D3695, 0xAFDC5620273D3CF1, 0xADF85458A2BB4A9A, 0xFFFFFFFFFFFFFFFF,
+};
+constexpr uint64_t DH_FFDHE3072_R[48] = {
+    0x0000000000000001, 0xDA1BE2D49939D1C8, 0xC3E4DF11C02A6283, 0xF5432F9405AC2210,
+    0xE24065BD2A3BB7B1, 0x543ADE6864F21525, 0x1792D43ADDC9C5F2, 0xA3517D5463620961,
+    0x9B0D1DE18E0AB400, 0x0B02BBAD1D28B22C, 0x4BECF36C43BC86BB, 0x5101ECF67AEC6D8F,
+    0xA6734F053E7926E3, 0x8526E2D96E080811, 0x9E4B9036291936F8, 0x43CB0B210663FDC7,
+    0x21CAA4C49AE6FCA4, 0x7794BDC79EE03023, 0x390CB5D93E4D1005, 0x3A710E7C82E97C4D,
+    0xC44A0343D13DDFFA, 0x3C01C4E4B390528C, 0x71B0EDCD110D7E7C, 0x6E8D0163167A7C00,
+    0x3FCBFB32D7CBD09E, 0x61FD031E32081D13, 0xF4F8583711F5928F, 0x51A912189C8D44E6,
+    0xE2B0BD5C21C6B20B, 0x469525489F280B97, 0x2EF756B44D371C04, 0x43F54E7D4CDB049E,
+    0xCF5335B0B7C58685, 0xE20EA75EC95218CA, 0x1D5976250C10178D, 0x67B0F38F1F197488,
+    0x4AA8ECA180A836CA, 0x7A9C9AAAC212E50C, 0xDBCC0AE0A0F9912F, 0x2C20E12A2A029A9E,
+    0x097E4DFD513B9E85, 0x82D01C9C9CF38A27, 0x336C6231DB64C106, 0x561EC9BEEB9BCC04,
+    0x27463A7C31D2C96A, 0x5023A9DFD8C2C30E, 0x5207ABA75D44B565, 0x0000000000000000,
+};
+constexpr uint64_t DH_FFDHE3072_R2[48] = {
+    0xFA1861EC14BA1560, 0x6D42CB5B17BC46DC, 0x29B38C9F17D3B9EE, 0x84E19B8A4F2F19C7,
+    0xD2EE9266736DC403, 0x4A4D777D71FAD32A, 0x9B87C4093CF55AFA, 0x783B269A46A689AE,
+    0x817ADCF831676817, 0xA793367B56DAFD28, 0x2E90CB1352F92170, 0x6E078202E05502DB,
+    0x373694DCDE5E6992, 0xE8283C273157A6FC, 0x76FFEA53A3C753B3, 0xD4FAA7C313AAD0C3,
+    0xD8BBA3113B3C4F5D, 0x622011D2E7DEE086, 0xF8FA1E549EDE734F, 0xCA830FC7E9C9AACD,
+    0x27313949C5D2B6B9, 0xB1B2A765C8382B42, 0xB593A5A31DBB969A, 0xADAD49E21E8EA35A,
+    0x73F3196878672689, 0x9E1242144781117F, 0x47C2F1201F7E26BF, 0x051B9E86AF98B240,
+    0xD17F17645D31B3E1, 0xB957D0168AA30DBD, 0x5CEF7FEB3065C063, 0xFBA48A97194AC0C3,
+    0x7F3B09C2874C8BD6, 0x336ADD6A568174B6, 0x8E6698AC54503DB2, 0x06A7F1F979DDBC72,
+    0xBDE2B9C392D11C5F, 0x27DEA14FE4181598, 0x10CE037CD0D96E9F, 0xB01833B509E7823D,
+    0xB9631002BCD3A514, 0x7829CC5363F6C287, 0xDC47AA6EDD2410F7, 0xCF12DFC2D3CE8737,
+    0x235844DCD86373C1, 0x6ED9EEADF80F1D3B, 0xF128E8A3BC34B85A, 0xA15C076B8EBA952B,
+};
+
+// ffdhe4096: RFC 7919, 4096 bit
+constexpr uint64_t DH_FFDHE4096_P[64] = {
+    0xFFFFFFFFFFFFFFFF, 0xC68A007E5E655F6A, 0x4DB5A851F44182E1, 0x8EC9B55A7F88A46B,
+    0x0A8291CDCEC97DCF, 0x2A4ECEA9F98D0ACC, 0x1A1DB93D7140003C, 0x092999A333CB8B7A,
+    0x6DC778F971AD0038, 0xA907600A918130C4, 0xED6A1E012D9E6832, 0x7135C886EFB4318A,
+    0x87F55BA57E31CC7A, 0x7763CF1D55034004, 0xAC7D5F42D69F6D18, 0x7930E9E4E58857B6,
+    0x6E6F52C3164DF4FB, 0x25E41D2B669E1EF1, 0x3C1B20EE3FD59D7C, 0x0ABCD06BFA53DDEF,
+    0x1DBF9A42D5C4484E, 0xABC521979B0DEADA, 0xE86D2BC522363A0D, 0x5CAE82AB9C9DF69E,
+    0x64F2E21E71F54BFF, 0xF4FD4452E2D74DD3, 0xB4130C93BC437944, 0xAEFE130985139270,
+    0x598CB0FAC186D91C, 0x7AD91D2691F7F7EE, 0x61B46FC9D6E6C907, 0xBC34F4DEF99C0238,
+    0xDE355B3B6519035B, 0x886B4238611FCFDC, 0xC6F34A26C1B2EFFA, 0xC58EF1837D1683B2,
+    0x3BB5FCBC2EC22005, 0xC3FE3B1B4C6FAD73, 0x8E4F1232EEF28183, 0x9172FE9CE98583FF,
+    0xC03404CD28342F61, 0x9E02FCE1CDF7E2EC, 0x0B07A7C8EE0A6D70, 0xAE56EDE76372BB19,
+    0x1D4F42A3DE394DF4, 0xB96ADAB760D7F468, 0xD108A94BB2C8E3FB, 0xBC0AB182B324FB61,
+    0x30ACCA4F483A797A, 0x1DF158A136ADE735, 0xE2A689DAF3EFE872, 0x984F0C70E0E68B77,
+    0xB557135E7F57C935, 0x856365553DED1AF3, 0x2433F51F5F066ED0, 0xD3DF1ED5D5FD6561,
+    0xF681B202AEC4617A, 0x7D2FE363630C75D8, 0xCC939DCE249B3EF9, 0xA9E13641146433FB,
+    0xD8B9C583CE2D3695, 0xAFDC5620273D3CF1, 0xADF85458A2BB4A9A, 0xFFFFFFFFFFFFFFFF,
+};
+constexpr uint64_t DH_FFDHE4096_R[64] = {
+    0x0000000000000001, 0x3975FF81A19AA095, 0xB24A57AE0BBE7D1E, 0x71364AA580775B94,
+    0xF57D6E3231368230, 0xD5B131560672F533, 0xE5E246C28EBFFFC3, 0xF6D6665CCC347485,
+    0x923887068E52FFC7, 0x56F89FF56E7ECF3B, 0x1295E1FED26197CD, 0x8ECA3779104BCE75,
+    0x780AA45A81CE3385, 0x889C30E2AAFCBFFB, 0x5382A0BD296092E7, 0x86CF161B1A77A849,
+    0x9190AD3CE9B20B04, 0xDA1BE2D49961E10E, 0xC3E4DF11C02A6283, 0xF5432F9405AC2210,
+    0xE24065BD2A3BB7B1, 0x543ADE6864F21525, 0x1792D43ADDC9C5F2, 0xA3517D5463620961,
+    0x9B0D1DE18E0AB400, 0x0B02BBAD1D28B22C, 0x4BECF36C43BC86BB, 0x5101ECF67AEC6D8F,
+    0xA6734F053E7926E3, 0x8526E2D96E080811, 0x9E4B9036291936F8, 0x43CB0B210663FDC7,
+    0x21CAA4C49AE6FCA4, 0x7794BDC79EE03023, 0x390CB5D93E4D1005, 0x3A710E7C82E97C4D,
+    0xC44A0343D13DDFFA, 0x3C01C4E4B390528C, 0x71B0EDCD110D7E7C, 0x6E8D0163167A7C00,
+    0x3FCBFB32D7CBD09E, 0x61FD031E32081D13, 0xF4F8583711F5928F, 0x51A912189C8D44E6,
+    0xE2B0BD5C21C6B20B, 0x469525489F280B97, 0x2EF756B44D371C04, 0x43F54E7D4CDB049E,
+    0xCF5335B0B7C58685, 0xE20EA75EC95218CA, 0x1D5976250C10178D, 0x67B0F38F1F197488,
+    0x4AA8ECA180A836CA, 0x7A9C9AAAC212E50C, 0xDBCC0AE0A0F9912F, 0x2C20E12A2A029A9E,
+    0x097E4DFD513B9E85, 0x82D01C9C9CF38A27, 0x336C6231DB64C106, 0x561EC9BEEB9BCC04,
+    0x27463A7C31D2C96A, 0x5023A9DFD8C2C30E, 0x5207ABA75D44B565, 0x0000000000000000,
+};
+constexpr uint64_t DH_FFDHE4096_R2[64] = {
+    0xA7C622B7CFB2CC2D, 0xEC79158587B51100, 0x126A70AAF62F758E, 0x6EB26DC72ABF5627,
+    0x5E5E28FAAAB1DD5D, 0x1F41DC52ED9C5B4F, 0x2BCD0155DD2E3F31, 0x7EC0216ED3AE9350,
+    0x81370E542C8F269A, 0xE9E47FD2FB803A65, 0x4B38DCE2D458F61C, 0x34057F484C3D506F,
+    0x602EE0776EF6E316, 0x039EA0B3417F652A, 0x7EDAB7F61350180A, 0x7B289A4F4CC0831B,
+    0xCAA445EFE222F8A0, 0x1216D38D5A710FEF, 0x604FF365115B49C1, 0x21435670B591370E,
+    0x111D16FA00C9A449, 0xC94C3190F543C1C9, 0x6322EE9CC3967E50, 0x832C0E85F8357C2F,
+    0x58D3EAEF1C794A4E, 0xA878F4D49B5910F9, 0x162F974111BF2792, 0x4C3B00D98C45D734,
+    0x2E2E3AA917DF4770, 0xACA0555A19B5FACD, 0xA2E0D202150E35D7, 0xFF669CC30E05C9C8,
+    0x24DEB0227D48FF6A, 0x713CE8A48FFFBC83, 0xBC4DD3102E6F5FBF, 0x6B89E3E91844BA5C,
+    0x40B6B57EFA3A6FA3, 0x7180442E3F18FF71, 0x119D4A453023A5BB, 0xDE7A0666456B50EE,
+    0xC9B6FABA81D4E216, 0x8CB8A1C246C53ECC, 0x551F30B27152FD09, 0x82B12E47ABBCF4FC,
+    0x0B049BF047427B9B, 0x09CE26FC63DCB628, 0x6AEB2E33B0B7A102, 0x57115408C29E4CF6,
+    0xC9EB898763438AB1, 0x226A8A8E677D0EC7, 0x12D20272C64244CA, 0xADB09E22BD27EEA4,
+    0x5F59F6B0AB45F30B, 0x4DA9766C9CEB3548, 0x0F1A8DF669C89E34, 0xBDC4A37D887BEBF6,
+    0xB56EA5B6B85BC3B1, 0x7369BC4DEA70D999, 0x24D6C8EEF2B79C5D, 0x91B4755B94DB499F,
+    0x0E12A8D373DC2145, 0xCC49DDBC0A74A965, 0x6FCAA672721AFD71, 0x9CE5B1970FD8C13A,
+};
+
+// ffdhe6144: RFC 7919, 6144 bit
+constexpr uint64_t DH_FFDHE6144_P[96] = {
+    0xFFFFFFFFFFFFFFFF, 0xA40E329CD0E40E65, 0xA41D570D7938DAD4, 0x62A69526D43161C1,
+    0x3FDD4A8E9ADB1E69, 0x5B3B71F9DC6B80D6, 0xEC9D1810C6272B04, 0x8CCF2DD5CACEF403,
+    0xE49F5235C95B9117, 0x505DC82DB854338A, 0x62292C311562A846, 0xD72B03746AE77F5E,
+    0xF9C9091B462D538C, 0x0AE8DB5847A67CBE, 0xB3A739C122611682, 0xEEAAC0232A281BF6,
+    0x94C6651E77CAF992, 0x763E4E4B94B2BBC1, 0x587E38DA0077D9B4, 0x7FB29F8C183023C3,
+    0x0ABEC1FFF9E3A26E, 0xA00EF092350511E3, 0xB855322EDB6340D8, 0xA52471F7A9A96910,
+    0x388147FB4CFDB477, 0x9B1F5C3E4E46041F, 0xCDAD0657FCCFEC71, 0xB38E8C334C701C3A,
+    0x917BDD64B1C0FD4C, 0x3BB454329B7624C8, 0x23BA4442CAF53EA6, 0x4E677D2C38532A3A,
+    0x0BFD64B645036C7A, 0xC68A007E5E0DD902, 0x4DB5A851F44182E1, 0x8EC9B55A7F88A46B,
+    0x0A8291CDCEC97DCF, 0x2A4ECEA9F98D0ACC, 0x1A1DB93D7140003C, 0x092999A333CB8B7A,
+    0x6DC778F971AD0038, 0xA907600A918130C4, 0xED6A1E012D9E6832, 0x7135C886EFB4318A,
+    0x87F55BA57E31CC7A, 0x7763CF1D55034004, 0xAC7D5F42D69F6D18, 0x7930E9E4E58857B6,
+    0x6E6F52C3164DF4FB, 0x25E41D2B669E1EF1, 0x3C1B20EE3FD59D7C, 0x0ABCD06BFA53DDEF,
+    0x1DBF9A42D5C4484E, 0xABC521979B0DEADA, 0xE86D2BC522363A0D, 0x5CAE82AB9C9DF69E,
+    0x64F2E21E71F54BFF, 0xF4FD4452E2D74DD3, 0xB4130C93BC437944, 0xAEFE130985139270,
+    0x598CB0FAC186D91C, 0x7AD91D2691F7F7EE, 0x61B46FC9D6E6C907, 0xBC34F4DEF99C0238,
+    0xDE355B3B6519035B, 0x886B4238611FCFDC, 0xC6F34A26C1B2EFFA, 0xC58EF1837D1683B2,
+    0x3BB5FCBC2EC22005, 0xC3FE3B1B4C6FAD73, 0x8E4F1232EEF28183, 0x9172FE9CE98583FF,
+    0xC03404CD28342F61, 0x9E02FCE1CDF7E2EC, 0x0B07A7C8EE0A6D70, 0xAE56EDE76372BB19,
+    0x1D4F42A3DE394DF4, 0xB96ADAB760D7F468, 0xD108A94BB2C8E3FB, 0xBC0AB182B324FB61,
+    0x30ACCA4F483A797A, 0x1DF158A136ADE735, 0xE2A689DAF3EFE872, 0x984F0C70E0E68B77,
+    0xB557135E7F57C935, 0x856365553DED1AF3, 0x2433F51F5F066ED0, 0xD3DF1ED5D5FD6561,
+    0xF681B202AEC4617A, 0x7D2FE363630C75D8, 0xCC939DCE249B3EF9, 0xA9E13641146433FB,
+    0xD8B9C583CE2D3695, 0xAFDC5620273D3CF1, 0xADF85458A2BB4A9A, 0xFFFFFFFFFFFFFFFF,
+};
+constexpr uint64_t DH_FFDHE6144_R[96] = {
+    0x0000000000000001, 0x5BF1CD632F1BF19A, 0x5BE2A8F286C7252B, 0x9D596AD92BCE9E3E,
+    0xC022B5716524E196, 0xA4C48E0623947F29, 0x1362E7EF39D8D4FB, 0x7330D22A35310BFC,
+    0x1B60ADCA36A46EE8, 0xAFA237D247ABCC75, 0x9DD6D3CEEA9D57B9, 0x28D4FC8B951880A1,
+    0x0636F6E4B9D2AC73, 0xF51724A7B8598341, 0x4C58C63EDD9EE97D, 0x11553FDCD5D7E409,
+    0x6B399AE18835066D, 0x89C1B1B46B4D443E, 0xA781C725FF88264B, 0x804D6073E7CFDC3C,
+    0xF5413E00061C5D91, 0x5FF10F6DCAFAEE1C, 0x47AACDD1249CBF27, 0x5ADB8E08565696EF,
+    0xC77EB804B3024B88, 0x64E0A3C1B1B9FBE0, 0x3252F9A80330138E, 0x4C7173CCB38FE3C5,
+    0x6E84229B4E3F02B3, 0xC44BABCD6489DB37, 0xDC45BBBD350AC159, 0xB19882D3C7ACD5C5,
+    0xF4029B49BAFC9385, 0x3975FF81A1F226FD, 0xB24A57AE0BBE7D1E, 0x71364AA580775B94,
+    0xF57D6E3231368230, 0xD5B131560672F533, 0xE5E246C28EBFFFC3, 0xF6D6665CCC347485,
+    0x923887068E52FFC7, 0x56F89FF56E7ECF3B, 0x1295E1FED26197CD, 0x8ECA3779104BCE75,
+    0x780AA45A81CE3385, 0x889C30E2AAFCBFFB, 0x5382A0BD296092E7, 0x86CF161B1A77A849,
+    0x9190AD3CE9B20B04, 0xDA1BE2D49961E10E, 0xC3E4DF11C02A6283, 0xF5432F9405AC2210,
+    0xE24065BD2A3BB7B1, 0x543ADE6864F21525, 0x1792D43ADDC9C5F2, 0xA3517D5463620961,
+    0x9B0D1DE18E0AB400, 0x0B02BBAD1D28B22C, 0x4BECF36C43BC86BB, 0x5101ECF67AEC6D8F,
+    0xA6734F053E7926E3, 0x8526E2D96E080811, 0x9E4B9036291936F8, 0x43CB0B210663FDC7,
+    0x21CAA4C49AE6FCA4, 0x7794BDC79EE03023, 0x390CB5D93E4D1005, 0x3A710E7C82E97C4D,
+    0xC44A0343D13DDFFA, 0x3C01C4E4B390528C, 0x71B0EDCD110D7E7C, 0x6E8D0163167A7C00,
+    0x3FCBFB32D7CBD09E, 0x61FD031E32081D13, 0xF4F8583711F5928F, 0x51A912189C8D44E6,
+    0xE2B0BD5C21C6B20B, 0x469525489F280B97, 0x2EF756B44D371C04, 0x43F54E7D4CDB049E,
+    0xCF5335B0B7C58685, 0xE20EA75EC95218CA, 0x1D5976250C10178D, 0x67B0F38F1F197488,
+    0x4AA8ECA180A836CA, 0x7A9C9AAAC212E50C, 0xDBCC0AE0A0F9912F, 0x2C20E12A2A029A9E,
+    0x097E4DFD513B9E85, 0x82D01C9C9CF38A27, 0x336C6231DB64C106, 0x561EC9BEEB9BCC04,
+    0x27463A7C31D2C96A, 0x5023A9DFD8C2C30E, 0x5207ABA75D44B565, 0x0000000000000000,
+};
+constexpr uint64_t DH_FFDHE6144_R2[96] = {
+    0x3FA9B7FF4A5C0EF7, 0x1DD8BFC89B14E142, 0x6EB2BAB9B0A7EF9D, 0x6A8E94ACE4F4CF40,
+    0x933DF6EBC6D56A8C, 0xDBBB680DE18BAB6E, 0xFCEF3BCFB6A7BCB0, 0x87EED6093ED20A53,
+    0x26CF51733E01BB2B, 0xC12C8582EEDB048A, 0x2A277280F6055D1E, 0x31B9842FE4965B7D,
+    0x05D6A6E5D91BAD16, 0x0F4E55E05121545A, 0x4CF21C778CF80F66, 0x8ED0463D501A1B89,
+    0x9962A22E94B74239, 0xB9054CB2FF58C5A6, 0x851058A42471359E, 0x7796D693A074EEF9,
+    0x020881815174D289, 0x1CD077BE2C4F8495, 0x298C9CF868F8CA51, 0x1AC28D20FDE8549B,
+    0xD2127CF741DCB6BF, 0x547044D58FC9B8C5, 0x6AAAE35A34CD463C, 0x6F3109EE75C765DF,
+    0x1A516E38B04633F7, 0x90D9A69F6F482146, 0x5C846897A85B0DA6, 0xB0F7C37664CE4192,
+    0x9710388F13E95C74, 0x725C8EB6F2531BB7, 0xD0D32EB29A6C32B1, 0x1A0A4B1672650B80,
+    0xCB98AB2842F05704, 0x9C656D03D0B23D0D, 0x2E458742E7B54491, 0xE2AAFB632A8E81A4,
+    0x1E94BC1CD8247A89, 0xE166C93846BA72C0, 0xF0F82042C2932D3C, 0x0621586FFE4ACF1E,
+    0x04BE671D1D74AB9F, 0x4AEBF9AF90CBD33D, 0xD6C845B7F006C8AE, 0xC684BCB23A8BCDEB,
+    0x34A2B4F546B7EABD, 0x34E4435D3B86DA40, 0x469243FBE2266C66, 0x6A80801394A11268,
+    0x1BCF14825E77C8BF, 0x96D4E92FA928F541, 0xF6A42C5A03AFE8FD, 0x47DCC426624A9839,
+    0x8BA1C9940BD88303, 0xB9DFA9A43F6F98B3, 0xDA99702CEAD0251C, 0x0C00B7A0AF2472CD,
+    0xB7368EC89CD98C3C, 0x87766F3AA8FCDA57, 0x29C1A4ED57D9E4B7, 0xF5925079E85512B0,
+    0x023758F2E167AEAB, 0x14E64E57E3BEDAEF, 0x94BD4812C5492644, 0x55C3BD86467CF1C8,
+    0xFE3C6F175BD3A9FD, 0x2C768DBE8FA5577F, 0x01B19042F569644E, 0x479C5400E4F37182,
+    0xDFBEA79F6086A660, 0xC030E4A12954C702, 0xC38DCD5162BEB813, 0xB0B612D687A09107,
+    0xBBCF2C7330002A2E, 0x57AD1C82C6CAEF9B, 0xF15E16DA5C78FCD3, 0x327DBB7564142502,
+    0xDD413A0623522432, 0x7C1476FBFD60C4B9, 0xBC72484889A39FA5, 0x17B6ED3C5C39561A,
+    0xAC318E9469784B23, 0x20B258E37B72BFC5, 0xF8E147FE28564406, 0xC670AF9F065B7710,
+    0xF7CFCC2F86E7A3ED, 0xA9D9F206E4A339D0, 0x3F66AC2C68091B40, 0x119E052522256D95,
+    0xBD92AAE1B37DF47A, 0x2DD9450D873B2693, 0x15C4D958F0E5B8EB, 0x9ED04DB973658357,
+};
+
+// ffdhe8192: RFC 7919, 8192 bit
+constexpr uint64_t DH_FFDHE8192_P[128] = {
+    0xFFFFFFFFFFFFFFFF, 0xD68C8BB7C5C6424C, 0x011E2A94838FF88C, 0x0822E506A9F4614E,
+    0x97D11D49F7A8443D, 0xA6BBFDE530677F0D, 0x2F741EF8C1FE86FE, 0xFAFABE1C5D71A87E,
+    0xDED2FBABFBE58A30, 0xB6855DFE72B0A66E, 0x1EFC8CE0BA8A4FE8, 0x83F81D4A3F2FA457,
+    0xA1FE3075A577E231, 0xD5B8019488D9C0A0, 0x624816CDAD9A95F9, 0x99E9E31650C1217B,
+    0x51AA691E0E423CFC, 0x1C217E6C3826E52C, 0x51A8A93109703FEE, 0xBB7099876A460E74,
+    0x541FC68C9C86B022, 0x59160CC046FD8251, 0x2846C0BA35C35F5C, 0x54504AC78B758282,
+    0x29388839D2AF05E4, 0xCB2C0F1CC01BD702, 0x555B2F747C932665, 0x86B63142A3AB8829,
+    0x0B8CC3BDF64B10EF, 0x687FEB69EDD1CC5E, 0xFDB23FCEC9509D43, 0x1E425A31D951AE64,
+    0x36AD004CF600C838, 0xA40E329CCFF46AAA, 0xA41D570D7938DAD4, 0x62A69526D43161C1,
+    0x3FDD4A8E9ADB1E69, 0x5B3B71F9DC6B80D6, 0xEC9D1810C6272B04, 0x8CCF2DD5CACEF403,
+    0xE49F5235C95B9117, 0x505DC82DB854338A, 0x62292C311562A846, 0xD72B03746AE77F5E,
+    0xF9C9091B462D538C, 0x0AE8DB5847A67CBE, 0xB3A739C122611682, 0xEEAAC0232A281BF6,
+    0x94C6651E77CAF992, 0x763E4E4B94B2BBC1, 0x587E38DA0077D9B4, 0x7FB29F8C183023C3,
+    0x0ABEC1FFF9E3A26E, 0xA00EF092350511E3, 0xB855322EDB6340D8, 0xA52471F7A9A96910,
+    0x388147FB4CFDB477, 0x9B1F5C3E4E46041F, 0xCDAD0657FCCFEC71, 0xB38E8C334C701C3A,
+    0x917BDD64B1C0FD4C, 0x3BB454329B7624C8, 0x23BA4442CAF53EA6, 0x4E677D2C38532A3A,
+    0x0BFD64B645036C7A, 0xC68A007E5E0DD902, 0x4DB5A851F44182E1, 0x8EC9B55A7F88A46B,
+    0x0A8291CDCEC97DCF, 0x2A4ECEA9F98D0ACC, 0x1A1DB93D7140003C, 0x092999A333CB8B7A,
+    0x6DC778F971AD0038, 0xA907600A918130C4, 0xED6A1E012D9E6832, 0x7135C886EFB4318A,
+    0x87F55BA57E31CC7A, 0x7763CF1D55034004, 0xAC7D5F42D69F6D18, 0x7930E9E4E58857B6,
+    0x6E6F52C3164DF4FB, 0x25E41D2B669E1EF1, 0x3C1B20EE3FD59D7C, 0x0ABCD06BFA53DDEF,
+    0x1DBF9A42D5C4484E, 0xABC521979B0DEADA, 0xE86D2BC522363A0D, 0x5CAE82AB9C9DF69E,
+    0x64F2E21E71F54BFF, 0xF4FD4452E2D74DD3, 0xB4130C93BC437944, 0xAEFE130985139270,
+    0x598CB0FAC186D91C, 0x7AD91D2691F7F7EE, 0x61B46FC9D6E6C907, 0xBC34F4DEF99C0238,
+    0xDE355B3B6519035B, 0x886B4238611FCFDC, 0xC6F34A26C1B2EFFA, 0xC58EF1837D1683B2,
+    0x3BB5FCBC2EC22005, 0xC3FE3B1B4C6FAD73, 0x8E4F1232EEF28183, 0x9172FE9CE98583FF,
+    0xC03404CD28342F61, 0x9E02FCE1CDF7E2EC, 0x0B07A7C8EE0A6D70, 0xAE56EDE76372BB19,
+    0x1D4F42A3DE394DF4, 0xB96ADAB760D7F468, 0xD108A94BB2C8E3FB, 0xBC0AB182B324FB61,
+    0x30ACCA4F483A797A, 0x1DF158A136ADE735, 0xE2A689DAF3EFE872, 0x984F0C70E0E68B77,
+    0xB557135E7F57C935, 0x856365553DED1AF3, 0x2433F51F5F066ED0, 0xD3DF1ED5D5FD6561,
+    0xF681B202AEC4617A, 0x7D2FE363630C75D8, 0xCC939DCE249B3EF9, 0xA9E13641146433FB,
+    0xD8B9C583CE2D3695, 0xAFDC5620273D3CF1, 0xADF85458A2BB4A9A, 0xFFFFFFFFFFFFFFFF,
+};
+constexpr uint64_t DH_FFDHE8192_R[128] = {
+    0x0000000000000001, 0x297374483A39BDB3, 0xFEE1D56B7C700773, 0xF7DD1AF9560B9EB1,
+    0x682EE2B60857BBC2, 0x5944021ACF9880F2, 0xD08BE1073E017901, 0x050541E3A28E5781,
+    0x212D0454041A75CF, 0x497AA2018D4F5991, 0xE103731F4575B017, 0x7C07E2B5C0D05BA8,
+    0x5E01CF8A5A881DCE, 0x2A47FE6B77263F5F, 0x9DB7E93252656A06, 0x66161CE9AF3EDE84,
+    0xAE5596E1F1BDC303, 0xE3DE8193C7D91AD3, 0xAE5756CEF68FC011, 0x448F667895B9F18B,
+    0xABE0397363794FDD, 0xA6E9F33FB9027DAE, 0xD7B93F45CA3CA0A3, 0xABAFB538748A7D7D,
+    0xD6C777C62D50FA1B, 0x34D3F0E33FE428FD, 0xAAA4D08B836CD99A, 0x7949CEBD5C5477D6,
+    0xF4733C4209B4EF10, 0x97801496122E33A1, 0x024DC03136AF62BC, 0xE1BDA5CE26AE519B,
+    0xC952FFB309FF37C7, 0x5BF1CD63300B9555, 0x5BE2A8F286C7252B, 0x9D596AD92BCE9E3E,
+    0xC022B5716524E196, 0xA4C48E0623947F29, 0x1362E7EF39D8D4FB, 0x7330D22A35310BFC,
+    0x1B60ADCA36A46EE8, 0xAFA237D247ABCC75, 0x9DD6D3CEEA9D57B9, 0x28D4FC8B951880A1,
+    0x0636F6E4B9D2AC73, 0xF51724A7B8598341, 0x4C58C63EDD9EE97D, 0x11553FDCD5D7E409,
+    0x6B399AE18835066D, 0x89C1B1B46B4D443E, 0xA781C725FF88264B, 0x804D6073E7CFDC3C,
+    0xF5413E00061C5D91, 0x5FF10F6DCAFAEE1C, 0x47AACDD1249CBF27, 0x5ADB8E08565696EF,
+    0xC77EB804B3024B88, 0x64E0A3C1B1B9FBE0, 0x3252F9A80330138E, 0x4C7173CCB38FE3C5,
+    0x6E84229B4E3F02B3, 0xC44BABCD6489DB37, 0xDC45BBBD350AC159, 0xB19882D3C7ACD5C5,
+    0xF4029B49BAFC9385, 0x3975FF81A1F226FD, 0xB24A57AE0BBE7D1E, 0x71364AA580775B94,
+    0xF57D6E3231368230, 0xD5B131560672F533, 0xE5E246C28EBFFFC3, 0xF6D6665CCC347485,
+    0x923887068E52FFC7, 0x56F89FF56E7ECF3B, 0x1295E1FED26197CD, 0x8ECA3779104BCE75,
+    0x780AA45A81CE3385, 0x889C30E2AAFCBFFB, 0x5382A0BD296092E7, 0x86CF161B1A77A849,
+    0x9190AD3CE9B20B04, 0xDA1BE2D49961E10E, 0xC3E4DF11C02A6283, 0xF5432F9405AC2210,
+    0xE24065BD2A3BB7B1, 0x543ADE6864F21525, 0x1792D43ADDC9C5F2, 0xA3517D5463620961,
+    0x9B0D1DE18E0AB400, 0x0B02BBAD1D28B22C, 0x4BECF36C43BC86BB, 0x5101ECF67AEC6D8F,
+    0xA6734F053E7926E3, 0x8526E2D96E080811, 0x9E4B9036291936F8, 0x43CB0B210663FDC7,
+    0x21CAA4C49AE6FCA4, 0x7794BDC79EE03023, 0x390CB5D93E4D1005, 0x3A710E7C82E97C4D,
+    0xC44A0343D13DDFFA, 0x3C01C4E4B390528C, 0x71B0EDCD110D7E7C, 0x6E8D0163167A7C00,
+    0x3FCBFB32D7CBD09E, 0x61FD031E32081D13, 0xF4F8583711F5928F, 0x51A912189C8D44E6,
+    0xE2B0BD5C21C6B20B, 0x469525489F280B97, 0x2EF756B44D371C04, 0x43F54E7D4CDB049E,
+    0xCF5335B0B7C58685, 0xE20EA75EC95218CA, 0x1D5976250C10178D, 0x67B0F38F1F197488,
+    0x4AA8ECA180A836CA, 0x7A9C9AAAC212E50C, 0xDBCC0AE0A0F9912F, 0x2C20E12A2A029A9E,
+    0x097E4DFD513B9E85, 0x82D01C9C9CF38A27, 0x336C6231DB64C106, 0x561EC9BEEB9BCC04,
+    0x27463A7C31D2C96A, 0x5023A9DFD8C2C30E, 0x5207ABA75D44B565, 0x0000000000000000,
+};
+constexpr uint64_t DH_FFDHE8192_R2[128] = {
+    0x87E50BBABB7A1708, 0x55981479EDD26314, 0x62AF6CB77FAB4C58, 0xC92419B8B118398F,
+    0xABCB594380C135CA, 0x183EE856AF9EF08B, 0xE95514C629B3FE6A, 0x4C29656FE73BC316,
+    0xA2F21E340F6CCB15, 0x71FA6ABD34AABF12, 0x9803DB160470D5EB, 0x398B85511EE081D2,
+    0xC46F284715DFD164, 0xC405FA3539A2F42E, 0xE1E15BBC8EF41090, 0x004B6EFCBE05DE05,
+    0x72CE2A38767C84D8, 0x8456A513B05B85EA, 0xB35A5B60C4C7B171, 0x2506C13FAFF8441D,
+    0x8F27802D1DA1E023, 0x70DE1E6A8A8A5C80, 0x8F74CA4651249B88, 0x61DC4CC687D3D798,
+    0xEA9505D6F8E83CE2, 0x5B80CB5F01B80101, 0x4EA092BC487F29E5, 0xF4D7AAAE5DD59160,
+    0x5F8B28F94BBFA4FF, 0x92413DD972F52F64, 0x66C859B986C6ACBE, 0xE1112A245A0A0DE4,
+    0xD548D288FEC06400, 0x9FEEA34645DF1612, 0xB4176B84ABDC42E5, 0x8DE95E95DAC35A73,
+    0xB23F6FF3E9F26566, 0xEAD81F3DC76C2B62, 0xF268CB65FD418A54, 0x0FD6FC1C0C6BD6F4,
+    0x62E1FF7DDA9BC1E4, 0xD1F76B7C71ADEBE5, 0x65C3962E67FC4619, 0xF6276626F8CF36D8,
+    0xC6900C3B1A2B2EBB, 0x4662C1A2E8863107, 0x2CB18D7A252D0F6E, 0xDBD8417C97E68962,
+    0x20F8D9D092FDB5DA, 0x4079CFE0B7B13360, 0x51474B9ADF2A061E, 0x0E18CA7D0989B4DB,
+    0x74A510593F908F44, 0xBC18268F86850435, 0x0EA798D8F4B8EED6, 0xD7F7A24DBF963959,
+    0x6FF20ECEF4C01E2C, 0x04F9252A220DDF04, 0x6A557279338E5A39, 0x7C3374A9D544D510,
+    0xE863D9509CD5A4B8, 0xE8F8F0E7FB9E0D0C, 0xE81B2CCC47C2DAD1, 0xE7A29FF5BE70A77D,
+    0xF62A98ED3F3A608E, 0xD39D779A71D17AA3, 0x43FAE26A09AB148F, 0x1CB251457F707954,
+    0xEA400B9C55172FAE, 0x9FD74762AAF1FE24, 0x7B28A14856EEE844, 0x4AB2BAA7D2090D83,
+    0xE64A3D12FBC541D3, 0xD2435B3315AC2EC5, 0x7507609F228FE310, 0xCE597520C797F5FB,
+    0x225259381BA93CD2, 0xFB04D60500E5231D, 0x2A839BF915301BC7, 0x6563F0D40C2A3C42,
+    0x23A454FA1040BBDF, 0x4F03577542281255, 0x61FD99B92343D3F5, 0xB57D79D48AD9FD49,
+    0xEC4762BB0BDC7955, 0x7B4006B0A576A898, 0xABCF3FEEE75E97D9, 0x78998D8B2FE98168,
+    0x2CC2CFE9532907F2, 0xFED80498D0AD246D, 0x7099130309A8008F, 0x42AE9AE20F042D63,
+    0x9AA06EE722C560D9, 0x5985040C5E2ABAD2, 0x430A2D3FCA272A2B, 0x93CDF2E40DCCC34B,
+    0x7760B2CE66FB1872, 0x75E0770485A54B0E, 0x2216F426B70E7FD1, 0xD0DB62020E2C14DF,
+    0x53638C4F2586F7E2, 0x4383A1446F6E335B, 0x50B99E334F66A8CA, 0xD5BD713ADACA5C1D,
+    0xA089215942A96F86, 0xD77DD7D7E6FDC3D9, 0xF95A279AC0CEF1FF, 0x8BE8735C18FD297E,
+    0x4DAB7AE21DAC7100, 0x68C0C367C91F3D13, 0x6D1BF51E637BD523, 0xAED53610C4979305,
+    0x454365271B043AF1, 0xD525867857CC1F25, 0x657BC6A9EC75680A, 0x2438C7E3B6E8EB29,
+    0x80159397FC55AE03, 0xD0BED6E6BA89E212, 0x652D570149B64463, 0xAED5A64FC645E49A,
+    0xB815DEB84B88901C, 0x7C8F94CB43C22862, 0x5C5D301F0F51D6A5, 0x31EA3BED32E2F1E2,
+    0xFD750D364486593C, 0x95AD6CA08C56665B, 0x3B672F3379D939E4, 0xCE028C79323E239A,
+};
+
+struct DHGroupParams
+{
+    const char *name;
+    size_t bits;
+    bool ffdhe;          // true: RFC 7919, false: RFC 3526
+    uint64_t generator;
+    size_t limbs;        // Số block 64 bit
+    uint64_t n0_inv;     // -p^-1 mod 2^64
+    const uint64_t *p;
+    const uint64_t *r_mod;
+    const uint64_t *r2_mod;
+};
+
+constexpr DHGroupParams DH_GROUPS[] = {
+    {"modp1536", 1536, false, 2, 24, 0x0000000000000001, DH_MODP1536_P, DH_MODP1536_R, DH_MODP1536_R2},
+    {"modp2048", 2048, false, 2, 32, 0x0000000000000001, DH_MODP2048_P, DH_MODP2048_R, DH_MODP2048_R2},
+    {"modp3072", 3072, false, 2, 48, 0x0000000000000001, DH_MODP3072_P, DH_MODP3072_R, DH_MODP3072_R2},
+    {"modp4096", 4096, false, 2, 64, 0x0000000000000001, DH_MODP4096_P, DH_MODP4096_R, DH_MODP4096_R2},
+    {"modp6144", 6144, false, 2, 96, 0x0000000000000001, DH_MODP6144_P, DH_MODP6144_R, DH_MODP6144_R2},
+    {"modp8192", 8192, false, 2, 128, 0x0000000000000001, DH_MODP8192_P, DH_MODP8192_R, DH_MODP8192_R2},
+    {"ffdhe2048", 2048, true, 2, 32, 0x0000000000000001, DH_FFDHE2048_P, DH_FFDHE2048_R, DH_FFDHE2048_R2},
+    {"ffdhe3072", 3072, true, 2, 48, 0x0000000000000001, DH_FFDHE3072_P, DH_FFDHE3072_R, DH_FFDHE3072_R2},
+    {"ffdhe4096", 4096, true, 2, 64, 0x0000000000000001, DH_FFDHE4096_P, DH_FFDHE4096_R, DH_FFDHE4096_R2},
+    {"ffdhe6144", 6144, true, 2, 96, 0x0000000000000001, DH_FFDHE6144_P, DH_FFDHE6144_R, DH_FFDHE6144_R2},
+    {"ffdhe8192", 8192, true, 2, 128, 0x0000000000000001, DH_FFDHE8192_P, DH_FFDHE8192_R, DH_FFDHE8192_R2},
+};
+
+// Kiểm tra hằng số lúc biên dịch: độ dài khớp số bit, bit cao nhất bật, p lẻ và n0_inv * p ≡ -1 (mod 2^64)
+constexpr bool dh_groups_valid()
+{
+    for (const DHGroupParams &g : DH_GROUPS)
+    {
+        if (g.limbs * 64 != g.bits || (g.p[g.limbs - 1] >> 63) == 0 || (g.p[0] & 1) == 0)
+            return false;
+        if (g.n0_inv * g.p[0] != ~(uint64_t)0)
+            return false;
+    }
+    return true;
+}
+static_assert(dh_groups_valid(), "Invalid built-in DH group constants!");
+
+// Nhóm dựng sẵn: p, g và ngữ cảnh Montgomery lấy thẳng từ hằng số
+// Mọi nhóm được tạo 1 lần (sao chép hằng số) ở lần tra cứu đầu tiên, sau đó chỉ đọc.
+class DHGroup
+{
+private:
+    const DHGroupParams &params;
+    MontgomeryContext ctx;
+    mutable once_flag table_once;
+    mutable unique_ptr<FixedBaseTable> table;
+
+    explicit DHGroup(const DHGroupParams &group)
+        : params(group), ctx(group.p, group.limbs, group.n0_inv, group.r_mod, group.r2_mod) {}
+
+    static const vector<unique_ptr<DHGroup>> &all()
+    {
+        static const vector<unique_ptr<DHGroup>> groups = []
+        {
+            // Sống đến hết chương trình --> không cấp phát từ arena của Scope đang mở
+            LimbArena::Suspend heap;
+            vector<unique_ptr<DHGroup>> list;
+            for (const DHGroupParams &group : DH_GROUPS)
+                list.emplace_back(new DHGroup(group));
+            return list;
+        }();
+        return groups;
+    }
+
+public:
+    DHGroup(const DHGroup &) = delete;
+    DHGroup &operator=(const DHGroup &) = delete;
+
+    // Tra theo tên ("modp2048", "ffdhe3072", ...), không có thì nullptr
+    static const DHGroup *find(const string &name)
+    {
+        for (const auto &group : all())
+        {
+            if (name == group->params.name)
+                return group.get();
+        }
+        return nullptr;
+    }
+
+    // Tra theo số bit của p; ffdhe: chọn nhóm RFC 7919 thay cho RFC 3526. Không có thì nullptr
+    static const DHGroup *by_bits(size_t bits, bool ffdhe = false)
+    {
+        for (const auto &group : all())
+        {
+            if (group->params.bits == bits && group->params.ffdhe == ffdhe)
+                return group.get();
+        }
+        return nullptr;
+    }
+
+    const char *name() const { return params.name; }
+    size_t bits() const { return params.bits; }
+    const BigInt &prime() const { return ctx.modulus(); }
+    BigInt generator() const { return BigInt(params.generator); }
+    const MontgomeryContext &context() const { return ctx; }
+
+    // Bảng lũy thừa cơ số cố định của g (hàng MB với nhóm lớn nên không nhúng sẵn):
+    // dựng 1 lần ở lần gọi đầu tiên từ ngữ cảnh có sẵn, an toàn khi nhiều thread cùng gọi
+    const FixedBaseTable &generator_table() const
+    {
+        call_once(table_once, [this]
+                  {
+                      LimbArena::Suspend heap;
+                      table.reset(new FixedBaseTable(generator(), ctx));
+                  });
+        return *table;
+    }
+};
@@ -1,4 +1,462 @@
 #include "diffie_hellman.h"
+#if defined(__AVX512IFMA__)
+#include <immintrin.h>
+#endif
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+// Đo đạc đường nóng
+// Khối đếm của 1 thread: chỉ thread đó ghi (relaxed), snapshot / reset đọc - ghi từ thread khác
+struct Instrumentation::ThreadBlock
+{
+    atomic<uint64_t> counters[COUNTER_COUNT];
+    atomic<uint64_t> calls[TIMER_COUNT];
+    atomic<uint64_t> total_ns[TIMER_COUNT];
+    atomic<uint64_t> buckets[TIMER_COUNT][BUCKETS];
+
+    ThreadBlock() { clear(); }
+
+    void clear()
+    {
+        for (auto &c : counters)
+            c.store(0, memory_order_relaxed);
+        for (size_t t = 0; t < TIMER_COUNT; t++)
+        {
+            calls[t].store(0, memory_order_relaxed);
+            total_ns[t].store(0, memory_order_relaxed);
+            for (auto &b : buckets[t])
+                b.store(0, memory_order_relaxed);
+        }
+    }
+
+    void add_to(Snapshot &s) const
+    {
+        for (size_t c = 0; c < COUNTER_COUNT; c++)
+            s.counters[c] += counters[c].load(memory_order_relaxed);
+        for (size_t t = 0; t < TIMER_COUNT; t++)
+        {
+            s.calls[t] += calls[t].load(memory_order_relaxed);
+            s.total_ns[t] += total_ns[t].load(memory_order_relaxed);
+            for (size_t b = 0; b < BUCKETS; b++)
+                s.buckets[t][b] += buckets[t][b].load(memory_order_relaxed);
+        }
+    }
+};
+
+mutex &Instrumentation::registry_mutex()
+{
+    static mutex m;
+    return m;
+}
+
+vector<Instrumentation::ThreadBlock *> &Instrumentation::registry()
+{
+    static vector<ThreadBlock *> blocks;
+    return blocks;
+}
+
+// Số đếm của các thread đã kết thúc
+Instrumentation::ThreadBlock &Instrumentation::retired()
+{
+    static ThreadBlock block;
+    return block;
+}
+
+/*
+    @logic
+    1. Lần đầu thread ghi: tạo khối đếm thread_local và đăng ký vào registry
+    2. Thread kết thúc: cộng khối của nó vào retired() rồi hủy đăng ký
+*/
+Instrumentation::ThreadBlock &Instrumentation::local()
+{
+    struct Holder
+    {
+        ThreadBlock block;
+        Holder()
+        {
+            lock_guard<mutex> lock(registry_mutex());
+            registry().push_back(&block);
+        }
+        ~Holder()
+        {
+            lock_guard<mutex> lock(registry_mutex());
+            Snapshot s{};
+            block.add_to(s);
+            ThreadBlock &r = retired();
+            for (size_t c = 0; c < COUNTER_COUNT; c++)
+                r.counters[c].fetch_add(s.counters[c], memory_order_relaxed);
+            for (size_t t = 0; t < TIMER_COUNT; t++)
+            {
+                r.calls[t].fetch_add(s.calls[t], memory_order_relaxed);
+                r.total_ns[t].fetch_add(s.total_ns[t], memory_order_relaxed);
+                for (size_t b = 0; b < BUCKETS; b++)
+                    r.buckets[t][b].fetch_add(s.buckets[t][b], memory_order_relaxed);
+            }
+            vector<ThreadBlock *> &blocks = registry();
+            blocks.erase(find(blocks.begin(), blocks.end(), &block));
+        }
+    };
+    thread_local Holder holder;
+    return holder.block;
+}
+
+void Instrumentation::add(Counter c, uint64_t n)
+{
+    local().counters[c].fetch_add(n, memory_order_relaxed);
+}
+
+// Bucket = vị trí bit cao nhất của ns (thang log2)
+void Instrumentation::record(Timer t, uint64_t ns)
+{
+    ThreadBlock &block = local();
+    size_t bucket = 63 - __builtin_clzll(ns | 1);
+    if (bucket >= BUCKETS)
+        bucket = BUCKETS - 1;
+    block.calls[t].fetch_add(1, memory_order_relaxed);
+    block.total_ns[t].fetch_add(ns, memory_order_relaxed);
+    block.buckets[t][bucket].fetch_add(1, memory_order_relaxed);
+}
+
+Instrumentation::Snapshot Instrumentation::snapshot()
+{
+    Snapshot s{};
+    lock_guard<mutex> lock(registry_mutex());
+    retired().add_to(s);
+    for (ThreadBlock *block : registry())
+        block->add_to(s);
+    return s;
+}
+
+void Instrumentation::reset()
+{
+    lock_guard<mutex> lock(registry_mutex());
+    retired().clear();
+    for (ThreadBlock *block : registry())
+        block->clear();
+}
+
+const char *Instrumentation::counter_name(Counter c)
+{
+    static const char *names[COUNTER_COUNT] = {
+        "candidates", "sieve_rejects", "mr_rounds", "mul_calls", "sqr_calls",
+        "reduce_calls", "div_calls", "mont_mul_calls", "mont_sqr_calls", "limbs_processed"};
+    return names[c];
+}
+
+const char *Instrumentation::timer_name(Timer t)
+{
+    static const char *names[TIMER_COUNT] = {
+        "modular_exponentiation", "modular_exponentiation_montgomery", "modular_exponentiation_consttime",
+        "is_prime_by_Miller_Rabin", "is_prime_by_Baillie_PSW",
+        "generate_prime", "generate_safe_prime", "generate_safe_prime_parallel", "generate_private_key",
+        "fixed_base_pow", "fixed_base_pow_consttime", "batch_modexp", "key_exchange_public_keys", "key_exchange_shared_secrets",
+        "key_pool_pop"};
+    return names[t];
+}
+
+string Instrumentation::to_text(const Snapshot &s)
+{
+    ostringstream os;
+    for (size_t c = 0; c < COUNTER_COUNT; c++)
+        os << counter_name((Counter)c) << " " << s.counters[c] << "\n";
+    for (size_t t = 0; t < TIMER_COUNT; t++)
+    {
+        if (!s.calls[t])
+            continue;
+        os << timer_name((Timer)t) << " calls=" << s.calls[t] << " mean_ns=" << s.total_ns[t] / s.calls[t] << "\n";
+        for (size_t b = 0; b < BUCKETS; b++)
+        {
+            if (s.buckets[t][b])
+                os << "  >=" << (1ULL << b) << "ns " << s.buckets[t][b] << "\n";
+        }
+    }
+    return os.str();
+}
+
+// Histogram ghi thành các cặp [cận dưới ns, số lần], chỉ các bucket khác 0
+string Instrumentation::to_json(const Snapshot &s)
+{
+    ostringstream os;
+    os << "{\"enabled\": " << (enabled() ? "true" : "false") << ", \"counters\": {";
+    for (size_t c = 0; c < COUNTER_COUNT; c++)
+        os << (c ? ", " : "") << "\"" << counter_name((Counter)c) << "\": " << s.counters[c];
+    os << "}, \"timers\": {";
+    bool first = true;
+    for (size_t t = 0; t < TIMER_COUNT; t++)
+    {
+        if (!s.calls[t])
+            continue;
+        os << (first ? "" : ", ") << "\"" << timer_name((Timer)t) << "\": {\"calls\": " << s.calls[t]
+           << ", \"total_ns\": " << s.total_ns[t] << ", \"buckets\": [";
+        bool first_bucket = true;
+        for (size_t b = 0; b < BUCKETS; b++)
+        {
+            if (!s.buckets[t][b])
+                continue;
+            os << (first_bucket ? "" : ", ") << "[" << (1ULL << b) << ", " << s.buckets[t][b] << "]";
+            first_bucket = false;
+        }
+        os << "]}";
+        first = false;
+    }
+    os << "}}";
+    return os.str();
+}
+
+// Vùng nhớ bump cho số tạm
+/*
+    @logic
+    1. Cấp phát: cắt tiếp trong chunk hiện tại; hết chỗ thì chuyển sang chunk kế (đã có sẵn từ lần trước)
+    hoặc xin chunk mới từ heap (tối thiểu CHUNK_BYTES), miễn tổng dung lượng không vượt limit
+    2. Scope ghi mốc (chunk, offset, used) lúc mở, đóng thì lùi về mốc --> chunk được dùng lại, không trả heap
+    3. Giải phóng từng khối không làm gì: số tạm chết theo Scope
+*/
+LimbArena *&LimbArena::active_slot()
+{
+    static thread_local LimbArena *slot = nullptr;
+    return slot;
+}
+
+LimbArena &LimbArena::local()
+{
+    static thread_local LimbArena arena;
+    return arena;
+}
+
+void *LimbArena::allocate(size_t bytes)
+{
+    size_t n = (bytes + 15) & ~(size_t)15;
+    if (!chunks.empty() && offset + n <= chunks[current].size)
+    {
+        void *p = chunks[current].mem.get() + offset;
+        offset += n;
+        used += n;
+        peak = max(peak, used);
+        return p;
+    }
+    // Chunk kế tiếp còn trống (đã lùi về từ Scope trước)
+    for (size_t i = current + 1; i < chunks.size(); i++)
+    {
+        if (chunks[i].size >= n)
+        {
+            current = i;
+            offset = n;
+            used += n;
+            peak = max(peak, used);
+            return chunks[i].mem.get();
+        }
+    }
+    size_t size = n > CHUNK_BYTES ? n : CHUNK_BYTES;
+    if (capacity + size > limit)
+    {
+        fallbacks++;
+        return nullptr;
+    }
+    chunks.push_back({unique_ptr<unsigned char[]>(new unsigned char[size]), size});
+    capacity += size;
+    current = chunks.size() - 1;
+    offset = n;
+    used += n;
+    peak = max(peak, used);
+    return chunks[current].mem.get();
+}
+
+bool LimbArena::extend(void *p, size_t old_bytes, size_t new_bytes)
+{
+    size_t old_n = (old_bytes + 15) & ~(size_t)15, new_n = (new_bytes + 15) & ~(size_t)15;
+    if (chunks.empty() || (unsigned char *)p + old_n != chunks[current].mem.get() + offset)
+        return false;
+    if (offset - old_n + new_n > chunks[current].size)
+        return false;
+    offset = offset - old_n + new_n;
+    used = used - old_n + new_n;
+    peak = max(peak, used);
+    return true;
+}
+
+LimbArena::Stats LimbArena::stats() const
+{
+    return {used, peak, capacity, limit, fallbacks};
+}
+
+LimbArena::Scope::Scope(LimbArena &arena) : arena(arena), previous(active_slot()), mark{arena.current, arena.offset, arena.used}
+{
+    active_slot() = &arena;
+}
+
+LimbArena::Scope::~Scope()
+{
+    arena.current = mark.chunk;
+    arena.offset = mark.offset;
+    arena.used = mark.used;
+    active_slot() = previous;
+}
+
+LimbArena::Suspend::Suspend() : saved(active_slot())
+{
+    active_slot() = nullptr;
+}
+
+LimbArena::Suspend::~Suspend()
+{
+    active_slot() = saved;
+}
+
+BigInt LimbArena::detach(const BigInt &x)
+{
+    Suspend heap;
+    return BigInt(x);
+}
+
+void *LimbArena::allocate_tagged(size_t bytes)
+{
+    LimbArena *arena = active();
+    void *base = arena ? arena->allocate(bytes + 16) : nullptr;
+    if (!base)
+    {
+        arena = nullptr;
+        base = ::operator new(bytes + 16);
+    }
+    *static_cast<LimbArena **>(base) = arena;
+    return static_cast<unsigned char *>(base) + 16;
+}
+
+void LimbArena::deallocate_tagged(void *p) noexcept
+{
+    void *base = static_cast<unsigned char *>(p) - 16;
+    if (!*static_cast<LimbArena **>(base))
+        ::operator delete(base);
+}
+
+// Mảng block của BigInt (lưu trữ nội tuyến cho số nhỏ)
+/*
+    @logic
+    1. Số có tối đa INLINE_LIMBS block nằm trong inline_buf, ptr trỏ vào inline_buf
+    2. Khi cần nhiều hơn: cấp phát (gấp đôi dung lượng) từ arena đang mở, không có thì từ heap, chép dữ liệu sang
+    Khối cuối cùng của arena được nới tại chỗ, không cần chép
+    3. Copy / move phải trỏ ptr vào inline_buf của chính đối tượng đích
+*/
+void LimbVector::grow(size_t min_cap)
+{
+    size_t new_cap = max(min_cap, cap * 2);
+    LimbArena *current = LimbArena::active();
+    if (arena && arena == current && arena->extend(ptr, cap * sizeof(uint32_t), new_cap * sizeof(uint32_t)))
+    {
+        cap = new_cap;
+        return;
+    }
+    uint32_t *buf = current ? static_cast<uint32_t *>(current->allocate(new_cap * sizeof(uint32_t))) : nullptr;
+    if (!buf)
+    {
+        current = nullptr;
+        buf = new uint32_t[new_cap];
+    }
+    copy(ptr, ptr + len, buf);
+    release();
+    ptr = buf;
+    cap = new_cap;
+    arena = current;
+}
+
+void LimbVector::release()
+{
+    if (!is_inline() && !arena)
+        delete[] ptr;
+}
+
+LimbVector::LimbVector(const LimbVector &other) : ptr(inline_buf), len(0), cap(INLINE_LIMBS), arena(nullptr)
+{
+    assign(other.begin(), other.end());
+}
+
+// Move: lấy luôn vùng nhớ heap của other, số nhỏ thì chép block nội tuyến
+LimbVector::LimbVector(LimbVector &&other) noexcept : ptr(inline_buf), len(other.len), cap(INLINE_LIMBS), arena(nullptr)
+{
+    if (other.is_inline())
+        copy(other.ptr, other.ptr + other.len, inline_buf);
+    else
+    {
+        ptr = other.ptr;
+        cap = other.cap;
+        arena = other.arena;
+        other.ptr = other.inline_buf;
+        other.cap = INLINE_LIMBS;
+        other.arena = nullptr;
+    }
+    other.len = 0;
+}
+
+LimbVector &LimbVector::operator=(const LimbVector &other)
+{
+    if (this != &other)
+        assign(other.begin(), other.end());
+    return *this;
+}
+
+LimbVector &LimbVector::operator=(LimbVector &&other) noexcept
+{
+    if (this == &other)
+        return *this;
+    if (other.is_inline())
+    {
+        // Giữ nguyên vùng nhớ hiện có, chỉ chép block
+        copy(other.ptr, other.ptr + other.len, ptr);
+        len = other.len;
+    }
+    else
+    {
+        release();
+        ptr = other.ptr;
+        len = other.len;
+        cap = other.cap;
+        arena = other.arena;
+        other.ptr = other.inline_buf;
+        other.cap = INLINE_LIMBS;
+        other.arena = nullptr;
+    }
+    other.len = 0;
+    return *this;
+}
+
+void LimbVector::resize(size_t n, uint32_t value)
+{
+    reserve(n);
+    if (n > len)
+        fill(ptr + len, ptr + n, value);
+    len = n;
+}
+
+void LimbVector::assign(size_t n, uint32_t value)
+{
+    reserve(n);
+    fill(ptr, ptr + n, value);
+    len = n;
+}
+
+void LimbVector::assign(const uint32_t *first, const uint32_t *last)
+{
+    size_t n = last - first;
+    reserve(n);
+    copy(first, last, ptr);
+    len = n;
+}
+
+bool LimbVector::operator==(const LimbVector &other) const
+{
+    return len == other.len && equal(ptr, ptr + len, other.ptr);
+}
+
 // Loại bỏ các chữ số "0" vô nghĩa
 /*
     @logic
@@ -46,27 +504,12 @@ BigInt::BigInt(uint64_t initData)
 /*
     @param decString (Chuỗi dec cho số lớn 512 bit)
     @logic
-    1. Duyệt
-    Lặp và kiểm tra từng ký tự. Nếu
-        - Không phải số : bỏ qua
-        - Là số: Cập nhật result
-    2. Gán lại result cho *this (đối tượng hiện tại đang được khởi tạo)
+    1. Ký tự không phải số: bỏ qua
+    2. Đọc tại chỗ bằng assign_decimal (gom 9 chữ số / block 10^9, số dài thì chia để trị)
 */
 BigInt::BigInt(const string &decString)
 {
-    BigInt result;
-    for (char c : decString)
-    {
-        if (!isdigit(c))
-        {
-            continue;
-        }
-        else
-        {
-            result = result * 10 + BigInt(c - '0');
-        }
-    }
-    *this = result;
+    assign_decimal(decString.data(), decString.size());
 }
 
 // Định nghĩa các toán tử
@@ -112,6 +555,37 @@ bool BigInt::operator>=(const BigInt &other) const
     return !(*this < other);
 }
 
+// So sánh với số nguyên nhỏ
+/*
+    @logic
+    Số có nhiều hơn 2 block luôn lớn hơn mọi uint64_t,
+    ngược lại ghép tối đa 2 block thành uint64_t rồi so sánh trực tiếp
+*/
+bool BigInt::operator==(uint64_t small) const
+{
+    if (data.size() > 2)
+        return false;
+    uint64_t value = 0;
+    for (size_t i = 0; i < data.size(); i++)
+        value |= (uint64_t)data[i] << (32 * i);
+    return value == small;
+}
+
+bool BigInt::operator<(uint64_t small) const
+{
+    if (data.size() > 2)
+        return false;
+    uint64_t value = 0;
+    for (size_t i = 0; i < data.size(); i++)
+        value |= (uint64_t)data[i] << (32 * i);
+    return value < small;
+}
+
+bool BigInt::operator>(uint64_t small) const
+{
+    return !(*this < small) && !(*this == small);
+}
+
 // Toán tử cộng
 /*
     @param other (BigInt cần cộng vào)
@@ -163,37 +637,143 @@ BigInt BigInt::operator+(const BigInt &other) const
 // Hỗ trợ trường hợp cộng số nguyên nhỏ, giúp tăng hiệu suất thay vì ép sang kiểu BigInt
 BigInt BigInt::operator+(uint64_t small) const
 {
-    BigInt res = *this;
-
-    uint32_t low = (uint32_t)small;
-    uint32_t high = (uint32_t)(small >> 32);
+    BigInt res;
+    res.data.reserve(max(data.size(), (size_t)2) + 1);
+    res.data.assign(data.begin(), data.end());
+    res += small;
+    return res;
+}
 
-    uint64_t sum = (uint64_t)res.data[0] + low;
-    res.data[0] = (uint32_t)sum;
-    uint64_t carry = sum >> 32;
+// Toán tử cộng - gán (tại chỗ)
+/*
+    @logic
+    1. Nới data tới độ dài của other (phần thêm là 0)
+    2. Cộng từng block kèm carry, hết other thì chỉ lan carry
+    3. Còn carry: thêm 1 block (dung lượng đủ thì không cấp phát)
+*/
+BigInt &BigInt::operator+=(const BigInt &other)
+{
+    size_t n = other.data.size();
+    if (data.size() < n)
+        data.resize(n);
+    uint64_t carry = 0;
+    size_t i = 0;
+    for (; i < n; i++)
+    {
+        uint64_t sum = (uint64_t)data[i] + other.data[i] + carry;
+        data[i] = (uint32_t)sum;
+        carry = sum >> 32;
+    }
+    for (; carry && i < data.size(); i++)
+    {
+        uint64_t sum = (uint64_t)data[i] + carry;
+        data[i] = (uint32_t)sum;
+        carry = sum >> 32;
+    }
+    if (carry)
+        data.push_back((uint32_t)carry);
+    return *this;
+}
 
-    size_t i = 1;
+BigInt &BigInt::operator+=(uint64_t small)
+{
+    // Đủ chỗ cho 2 block của small (block 0 dư sẽ được trim ở cuối)
+    if (data.size() < 2)
+        data.resize(2);
+    uint64_t sum = (uint64_t)data[0] + (uint32_t)small;
+    data[0] = (uint32_t)sum;
+    // carry <= 2^32: phần cao của small cộng số nhớ của block 0
+    uint64_t carry = (sum >> 32) + (small >> 32);
+    for (size_t i = 1; carry; i++)
+    {
+        if (i >= data.size())
+            data.push_back(0);
+        uint64_t s = (uint64_t)data[i] + carry;
+        data[i] = (uint32_t)s;
+        carry = s >> 32;
+    }
+    trim();
+    return *this;
+}
 
-    if (high || carry)
+// Toán tử trừ - gán (tại chỗ), *this < other: báo lỗi và trả về 0 như operator-
+BigInt &BigInt::operator-=(const BigInt &other)
+{
+    if (*this < other)
+    {
+        cout << "Lỗi, không thể thực hiện phép trừ cho ra kết quả âm" << endl;
+        data.resize(0);
+        return *this;
+    }
+    uint64_t borrow = 0;
+    size_t i = 0;
+    for (; i < other.data.size(); i++)
+    {
+        uint64_t diff = (uint64_t)data[i] - other.data[i] - borrow;
+        data[i] = (uint32_t)diff;
+        borrow = (diff >> 32) & 1;
+    }
+    for (; borrow && i < data.size(); i++)
     {
-        uint64_t sum2 = (uint64_t)res.data[1] + high + carry;
-        res.data[1] = (uint32_t)sum2;
-        carry = sum2 >> 32;
-        i = 2;
+        uint64_t diff = (uint64_t)data[i] - borrow;
+        data[i] = (uint32_t)diff;
+        borrow = (diff >> 32) & 1;
     }
+    trim();
+    return *this;
+}
+
+// Nhân - gán: tích tính trong bộ đệm 64 bit rồi ghi đè lên data (dùng lại vùng nhớ sẵn có)
+BigInt &BigInt::operator*=(const BigInt &other)
+{
+    multiply_to(*this, other, *this);
+    return *this;
+}
 
+BigInt &BigInt::operator*=(uint64_t small)
+{
+    if (small == 0)
+    {
+        data.resize(0);
+        return *this;
+    }
+    // data[i] * small + carry < 2^96
+    uint128_t carry = 0;
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        uint128_t cur = (uint128_t)data[i] * small + carry;
+        data[i] = (uint32_t)cur;
+        carry = cur >> 32;
+    }
     while (carry)
     {
-        if (i >= res.data.size())
-            res.data.push_back(0);
-        uint64_t s = (uint64_t)res.data[i] + carry;
-        res.data[i] = (uint32_t)s;
-        carry = s >> 32;
-        i++;
+        data.push_back((uint32_t)carry);
+        carry >>= 32;
     }
+    return *this;
+}
 
-    res.trim();
-    return res;
+// Nhân - cộng số nhỏ trong 1 lượt: data[i] * mul + carry < 2^64
+BigInt &BigInt::mul_add_small(uint32_t mul, uint32_t add)
+{
+    uint64_t carry = add;
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        uint64_t cur = (uint64_t)data[i] * mul + carry;
+        data[i] = (uint32_t)cur;
+        carry = cur >> 32;
+    }
+    if (carry)
+        data.push_back((uint32_t)carry);
+    trim();
+    return *this;
+}
+
+BigInt &BigInt::operator%=(const BigInt &mod)
+{
+    if (!(*this < mod))
+        *this = barrett_mod(*this, mod);
+    return *this;
 }
 
 // Toán tử trừ
@@ -247,112 +827,403 @@ BigInt BigInt::operator-(const BigInt &other) const
     return result;
 }
 
-// Thuật toán nhân Karatsuba
-// Nhân hai số lớn a và b bằng phương pháp chia để trị:
-// - Chia số lớn a và b thành 2 nửa (high và low)
-// - Nhân 3 phép nhân nhỏ: z0 = low1*low2, z2 = high1*high2, z1 = (low1+high1)*(low2+high2)
-// - Tính temp = z1 - z2 - z0
-// - Kết hợp: result = z2*(B^(2*m)) + temp*(B^m) + z0, B = 2^32
-// - Nếu số quá nhỏ (<64 block), dùng nhân bình thường
-// - Trim để loại bỏ các block 0 dư thừa
+// Thuật toán nhân Karatsuba / Toom-Cook 3
+// Nhân hai số lớn a và b:
+// - Gộp data thành block 64 bit, cấp phát 1 lần đủ cho toán hạng, kết quả và vùng nhớ tạm
+// - mul_limbs64 chọn nhân trường học / Karatsuba / Toom-3 theo kích thước, đệ quy chỉ dùng scratch
+// - Tách về block 32 bit và trim
 BigInt BigInt::karatsuba_multiply(const BigInt &a, const BigInt &b)
 {
-    // Nếu một trong hai số quá nhỏ (<64 block), dùng nhân bình thường
-    if (a.data.size() < 64 || b.data.size() < 64)
-    {
-        BigInt result;
-        // Cấp phát đủ chỗ cho tích
-        result.data.assign(a.data.size() + b.data.size(), 0);
-        // Nhân từng block uint32_t
-        for (size_t i = 0; i < a.data.size(); ++i)
-        {
-            uint64_t carry = 0;
-            for (size_t j = 0; j < b.data.size(); ++j)
-            {
-                // Cộng tích block hiện tại + carry vào result
-                uint64_t cur = (uint64_t)result.data[i + j] + (uint64_t)a.data[i] * b.data[j] + carry;
-                // lưu 32 bit thấp
-                result.data[i + j] = (uint32_t)(cur & 0xFFFFFFFF);
-                // 32 bit cao sang carry
-                carry = cur >> 32;
-            }
-            // Nếu còn carry, cộng vào các block tiếp theo
-            size_t k = i + b.data.size();
-            while (carry)
+    BigInt result;
+    multiply_to(a, b, result);
+    return result;
+}
+
+// Toán hạng được chép sang bộ đệm trước khi ghi out --> out trùng a hoặc b vẫn đúng
+void BigInt::multiply_to(const BigInt &a, const BigInt &b, BigInt &out)
+{
+    DH_COUNT(MUL_CALLS, 1);
+    DH_COUNT(LIMBS_PROCESSED, (a.data.size() + b.data.size() + 1) / 2);
+    if (a.data.empty() || b.data.empty())
+    {
+        out.data.resize(0);
+        return;
+    }
+    size_t na = (a.data.size() + 1) / 2, nb = (b.data.size() + 1) / 2;
+    // Kết quả đặt trước dung lượng ngoài Scope (còn dùng sau khi trả về),
+    // vùng nhớ tạm cho kernel lấy từ arena --> chỉ tối đa 1 lần cấp phát heap (của out)
+    out.data.reserve(2 * (na + nb));
+    LimbArena::Scope scope;
+    LimbBuffer buf(na + nb + (na + nb) + mul_scratch_limbs(max(na, nb)));
+    uint64_t *x = buf.data(), *y = x + na, *r = y + nb;
+    to_limbs64(a, x, na);
+    to_limbs64(b, y, nb);
+    mul_limbs64(x, na, y, nb, r, r + na + nb);
+    out.assign_limbs64(r, na + nb);
+}
+
+// Số block scratch cho mul_limbs64
+/*
+    @logic
+    Mỗi tầng Karatsuba dùng ~2n + 6 block, mỗi tầng Toom-3 dùng ~4n + 18 block, tách khối dùng <= 2n block;
+    các lời gọi đệ quy đều có kích thước <= n / 2 + 2 --> cộng dồn 6n + 64 mỗi tầng là đủ.
+*/
+size_t BigInt::mul_scratch_limbs(size_t n)
+{
+    if (n < KARATSUBA_CUTOFF)
+        return 0;
+    return 6 * n + 64 + mul_scratch_limbs(n / 2 + 2);
+}
+
+uint64_t BigInt::add_limbs64(uint64_t *r, size_t n, const uint64_t *x, size_t nx)
+{
+    uint64_t carry = 0;
+    size_t i = 0;
+    for (; i < nx; i++)
+    {
+        uint128_t cur = (uint128_t)r[i] + x[i] + carry;
+        r[i] = (uint64_t)cur;
+        carry = (uint64_t)(cur >> 64);
+    }
+    for (; carry && i < n; i++)
+        carry = ++r[i] == 0;
+    return carry;
+}
+
+uint64_t BigInt::sub_limbs64(uint64_t *r, size_t n, const uint64_t *x, size_t nx)
+{
+    uint64_t borrow = 0;
+    size_t i = 0;
+    for (; i < nx; i++)
+    {
+        uint128_t diff = (uint128_t)r[i] - x[i] - borrow;
+        r[i] = (uint64_t)diff;
+        borrow = (uint64_t)(diff >> 64) & 1;
+    }
+    for (; borrow && i < n; i++)
+        borrow = r[i]-- == 0;
+    return borrow;
+}
+
+// Nhân trên mảng block 64 bit
+/*
+    @param a, na, b, nb (Hai toán hạng, có thể có block 0 ở đầu cao)
+    @param r (na + nb block kết quả, không trùng a, b)
+    @param scratch (ít nhất mul_scratch_limbs(max(na, nb)) block)
+    @logic
+    1. Đảm bảo na >= nb
+    2. nb < KARATSUBA_CUTOFF: nhân trường học (hoặc square_limbs64 khi a == b)
+    3. nb <= (na + 1) / 2 (lệch kích thước): cắt a thành các khối nb block, nhân từng khối rồi cộng dồn
+    4. na >= TOOM3_CUTOFF và b đủ 3 phần: Toom-3, ngược lại Karatsuba
+    Ngưỡng đo bằng cách nhân 2 số cùng kích thước trên x86-64: Karatsuba thắng từ ~32 block (2048 bit),
+    Toom-3 thắng Karatsuba từ ~96 block (6144 bit).
+*/
+void BigInt::mul_limbs64(const uint64_t *a, size_t na, const uint64_t *b, size_t nb, uint64_t *r, uint64_t *scratch)
+{
+    if (na < nb)
+    {
+        swap(a, b);
+        swap(na, nb);
+    }
+    if (nb < KARATSUBA_CUTOFF)
+    {
+        if (a == b && na == nb)
+        {
+            square_limbs64(a, na, r);
+            return;
+        }
+        for (size_t i = 0; i < na + nb; i++)
+            r[i] = 0;
+        for (size_t i = 0; i < na; ++i)
+        {
+            uint64_t carry = 0;
+            for (size_t j = 0; j < nb; ++j)
             {
-                if (k >= result.data.size())
-                    result.data.push_back(0);
-                uint64_t cur = (uint64_t)result.data[k] + carry;
-                result.data[k] = (uint32_t)(cur & 0xFFFFFFFF);
-                carry = cur >> 32;
-                ++k;
+                // Cộng tích block hiện tại + carry vào r
+                uint128_t cur = (uint128_t)a[i] * b[j] + r[i + j] + carry;
+                r[i + j] = (uint64_t)cur;
+                carry = (uint64_t)(cur >> 64);
             }
+            // r[i + nb] chưa được cộng gì ở vòng i nên không tràn
+            r[i + nb] = carry;
         }
-        // loại bỏ block 0 dư thừa
-        result.trim();
-        return result;
+        return;
+    }
+    if (nb <= (na + 1) / 2)
+    {
+        // Tách khối: a = sum(a_i * B^(i * nb)), mỗi tích a_i * b là phép nhân cân bằng
+        fill(r, r + na + nb, 0);
+        uint64_t *tmp = scratch;
+        for (size_t i = 0; i < na; i += nb)
+        {
+            size_t len = min(nb, na - i);
+            mul_limbs64(a + i, len, b, nb, tmp, scratch + 2 * nb);
+            add_limbs64(r + i, na + nb - i, tmp, len + nb);
+        }
+        return;
     }
+    size_t k = (na + 2) / 3;
+    if (na >= TOOM3_CUTOFF && nb > 2 * k)
+        toom3_limbs64(a, na, b, nb, r, scratch);
+    else
+        karatsuba_limbs64(a, na, b, nb, r, scratch);
+}
 
-    // Nếu số lớn, dùng đệ quy Karatsuba
-    size_t n = max(a.data.size(), b.data.size());
-    // Chia đôi số block
-    size_t m = n / 2;
+// Karatsuba trên mảng block 64 bit (na >= nb > (na + 1) / 2)
+/*
+    @logic
+    a = a1 * B^m + a0, b = b1 * B^m + b0, m = (na + 1) / 2
+    1. z0 = a0 * b0 ghi thẳng vào r[0, 2m), z2 = a1 * b1 ghi thẳng vào r[2m, na + nb)
+    2. z1 = (a0 + a1) * (b0 + b1) - z0 - z2 trong scratch (trừ tại chỗ, không cần số tạm)
+    3. r += z1 * B^m
+*/
+void BigInt::karatsuba_limbs64(const uint64_t *a, size_t na, const uint64_t *b, size_t nb, uint64_t *r, uint64_t *scratch)
+{
+    bool sqr = a == b && na == nb;
+    size_t m = (na + 1) / 2;
+    uint64_t *sa = scratch, *sb = sa + m + 1, *z1 = sb + m + 1, *rest = z1 + 2 * m + 2;
 
-     // Chia a và b thành 2 nửa: high và low
-    BigInt high1, low1, high2, low2;
-    // nửa thấp của a
-    low1.data.assign(a.data.begin(), a.data.begin() + min(a.data.size(), m));
-    // nửa cao của a
-    if (a.data.size() > m)
-        high1.data.assign(a.data.begin() + m, a.data.end());
+    // sa = a0 + a1, sb = b0 + b1 (m + 1 block)
+    copy(a, a + m, sa);
+    sa[m] = add_limbs64(sa, m, a + m, na - m);
+    size_t nsa = sa[m] ? m + 1 : m;
+    size_t nsb = nsa;
+    if (!sqr)
+    {
+        copy(b, b + m, sb);
+        sb[m] = add_limbs64(sb, m, b + m, nb - m);
+        nsb = sb[m] ? m + 1 : m;
+    }
     else
-        high1 = BigInt(0);
+    {
+        sb = sa;
+    }
+
+    mul_limbs64(a, m, b, m, r, rest);
+    mul_limbs64(a + m, na - m, b + m, nb - m, r + 2 * m, rest);
+    fill(z1, z1 + 2 * m + 2, 0);
+    mul_limbs64(sa, nsa, sb, nsb, z1, rest);
+
+    sub_limbs64(z1, 2 * m + 2, r, 2 * m);
+    sub_limbs64(z1, 2 * m + 2, r + 2 * m, na + nb - 2 * m);
+    add_limbs64(r + m, na + nb - m, z1, min(2 * m + 2, na + nb - m));
+}
+
+// Toom-Cook 3 trên mảng block 64 bit (na >= TOOM3_CUTOFF, nb > 2k)
+/*
+    @logic
+    a = a2 * x^2 + a1 * x + a0, b tương tự, x = B^k, k = ceil(na / 3)
+    1. Giá trị tại 0, 1, -1, -2, vô cùng (E = k + 2 block, bù 2 mod B^E):
+        p(1) = a0 + a1 + a2, p(-1) = a0 - a1 + a2, p(-2) = 2 * (p(-1) + a2) - a0
+    2. 5 phép nhân đệ quy trên trị tuyệt đối: w0 = a0 * b0 -> r[0, 2k), winf = a2 * b2 -> r[4k, na + nb),
+        w1, w(-1), w(-2) trong scratch (L = 2k + 2 block, đổi dấu lại theo bù 2)
+    3. Nội suy Bodrato (mọi phép chia đều chia hết, tính mod B^L):
+        r3 = (w(-2) - w1) / 3, r1 = (w1 - w(-1)) / 2, r2 = w(-1) - w0
+        r3 = (r2 - r3) / 2 + 2 * winf, r2 = r2 + r1 - winf, r1 = r1 - r3
+    4. r += r1 * x + r2 * x^2 + r3 * x^3
+*/
+void BigInt::toom3_limbs64(const uint64_t *a, size_t na, const uint64_t *b, size_t nb, uint64_t *r, uint64_t *scratch)
+{
+    bool sqr = a == b && na == nb;
+    size_t k = (na + 2) / 3;
+    size_t E = k + 2, L = 2 * k + 2;
+    size_t na2 = na - 2 * k, nb2 = nb - 2 * k;
+    uint64_t *pa1 = scratch, *pam1 = pa1 + E, *pam2 = pam1 + E;
+    uint64_t *pb1 = pam2 + E, *pbm1 = pb1 + E, *pbm2 = pbm1 + E;
+    uint64_t *w1 = pbm2 + E, *wm1 = w1 + L, *wm2 = wm1 + L, *rest = wm2 + L;
 
-    // nửa thấp của b
-    low2.data.assign(b.data.begin(), b.data.begin() + min(b.data.size(), m));
-    // nửa cao của b
-    if (b.data.size() > m)
-        high2.data.assign(b.data.begin() + m, b.data.end());
+    // Đổi x (n block, bù 2) thành trị tuyệt đối, trả về true nếu âm
+    auto negate = [](uint64_t *x, size_t n)
+    {
+        uint64_t carry = 1;
+        for (size_t i = 0; i < n; i++)
+        {
+            x[i] = ~x[i] + carry;
+            carry = carry && x[i] == 0;
+        }
+    };
+    auto abs_sign = [&](uint64_t *x, size_t n)
+    {
+        bool neg = x[n - 1] >> 63;
+        if (neg)
+            negate(x, n);
+        return neg;
+    };
+    auto top = [](const uint64_t *x, size_t n)
+    {
+        while (n > 1 && x[n - 1] == 0)
+            n--;
+        return n;
+    };
+    // Tính p(1), p(-1), p(-2) của x0 + x1 * X + x2 * X^2 (x2 có n2 block)
+    auto evaluate = [&](const uint64_t *x, size_t n2, uint64_t *p1, uint64_t *pm1, uint64_t *pm2)
+    {
+        // p0 = x0 + x2 (tạm trong pm2)
+        fill(pm2, pm2 + E, 0);
+        copy(x, x + k, pm2);
+        add_limbs64(pm2, E, x + 2 * k, n2);
+        copy(pm2, pm2 + E, p1);
+        add_limbs64(p1, E, x + k, k);
+        copy(pm2, pm2 + E, pm1);
+        sub_limbs64(pm1, E, x + k, k);
+        // p(-2) = 2 * (p(-1) + x2) - x0
+        copy(pm1, pm1 + E, pm2);
+        add_limbs64(pm2, E, x + 2 * k, n2);
+        add_limbs64(pm2, E, pm2, E);
+        sub_limbs64(pm2, E, x, k);
+    };
+
+    evaluate(a, na2, pa1, pam1, pam2);
+    bool neg_am1 = abs_sign(pam1, E), neg_am2 = abs_sign(pam2, E);
+    bool neg_bm1 = neg_am1, neg_bm2 = neg_am2;
+    if (sqr)
+    {
+        pb1 = pa1;
+        pbm1 = pam1;
+        pbm2 = pam2;
+    }
     else
-        high2 = BigInt(0);
+    {
+        evaluate(b, nb2, pb1, pbm1, pbm2);
+        neg_bm1 = abs_sign(pbm1, E);
+        neg_bm2 = abs_sign(pbm2, E);
+    }
 
-    // Đệ quy: nhân các nửa nhỏ
-    BigInt z0 = karatsuba_multiply(low1, low2);    // z0 = low1*low2
-    BigInt z1 = karatsuba_multiply(low1 + high1, low2 + high2);  // z1 = (low1+high1)*(low2+high2)
-    BigInt z2 = karatsuba_multiply(high1, high2);    // z2 = high1*high2
+    // Nhân từng điểm; kết quả đặt trong L block (phần dư = 0)
+    auto point = [&](const uint64_t *x, const uint64_t *y, uint64_t *w)
+    {
+        size_t nx = top(x, E), ny = top(y, E);
+        if (x == y)
+            ny = nx;
+        fill(w, w + L, 0);
+        mul_limbs64(x, nx, y, ny, w, rest);
+    };
+    point(pa1, pb1, w1);
+    point(pam1, pbm1, wm1);
+    if (neg_am1 != neg_bm1)
+        negate(wm1, L);
+    point(pam2, pbm2, wm2);
+    if (neg_am2 != neg_bm2)
+        negate(wm2, L);
+    mul_limbs64(a, k, b, k, r, rest);
+    fill(r + 2 * k, r + 4 * k, 0);
+    mul_limbs64(a + 2 * k, na2, b + 2 * k, nb2, r + 4 * k, rest);
+    const uint64_t *w0 = r, *winf = r + 4 * k;
+    size_t n0 = 2 * k, ninf = na2 + nb2;
 
-    // Kết hợp kết quả
-    BigInt result;
-    // cấp phát đủ chỗ
-    result.data.assign((n + 1) * 2, 0);
-    // Thêm z0 vào phần thấp của result
-    for (size_t i = 0; i < z0.data.size(); ++i)
-        result.data[i] += z0.data[i];
-    // Tính temp = z1 - z2 - z0 (phần trung gian)
-    BigInt temp = z1 - z2 - z0;
-    // Thêm temp vào giữa result, bắt đầu từ vị trí m
-    for (size_t i = 0; i < temp.data.size(); ++i)
-        result.data[i + m] += temp.data[i];
-    // Thêm z2 vào nửa cao của result, bắt đầu từ 2*m
-    for (size_t i = 0; i < z2.data.size(); ++i)
-        result.data[i + 2 * m] += z2.data[i];
-
-    // Xử lý carry toàn bộ result
-    uint64_t carry = 0;
-    for (size_t i = 0; i < result.data.size(); ++i)
+    // Chia chính xác cho 3 mod B^L: q = x * 3^-1, carry là phần cao của 3q
+    auto divexact3 = [&](uint64_t *x)
     {
-        uint64_t cur = (uint64_t)result.data[i] + carry;
-        result.data[i] = (uint32_t)(cur & 0xFFFFFFFF);
-        carry = cur >> 32;
+        const uint64_t INV3 = 0xAAAAAAAAAAAAAAABULL;
+        uint64_t c = 0;
+        for (size_t i = 0; i < L; i++)
+        {
+            uint64_t s = x[i], t = s - c;
+            c = t > s;
+            uint64_t q = t * INV3;
+            x[i] = q;
+            c += (q > 0x5555555555555555ULL) + (q > 0xAAAAAAAAAAAAAAAAULL);
+        }
+    };
+    // Chia 2 có dấu (dịch phải số học)
+    auto half = [&](uint64_t *x)
+    {
+        for (size_t i = 0; i + 1 < L; i++)
+            x[i] = (x[i] >> 1) | (x[i + 1] << 63);
+        x[L - 1] = (uint64_t)((int64_t)x[L - 1] >> 1);
+    };
+
+    // r3 -> wm2, r1 -> w1, r2 -> wm1
+    sub_limbs64(wm2, L, w1, L);
+    divexact3(wm2);
+    sub_limbs64(w1, L, wm1, L);
+    half(w1);
+    sub_limbs64(wm1, L, w0, n0);
+    // r3 = (r2 - r3) / 2 + 2 * winf
+    for (size_t i = 0; i < L; i++)
+        wm2[i] = ~wm2[i];
+    add_limbs64(wm2, L, wm1, L);
+    uint64_t one = 1;
+    add_limbs64(wm2, L, &one, 1);
+    half(wm2);
+    add_limbs64(wm2, L, winf, ninf);
+    add_limbs64(wm2, L, winf, ninf);
+    // r2 = r2 + r1 - winf, r1 = r1 - r3
+    add_limbs64(wm1, L, w1, L);
+    sub_limbs64(wm1, L, winf, ninf);
+    sub_limbs64(w1, L, wm2, L);
+
+    size_t n = na + nb;
+    add_limbs64(r + k, n - k, w1, min(L, n - k));
+    add_limbs64(r + 2 * k, n - 2 * k, wm1, min(L, n - 2 * k));
+    add_limbs64(r + 3 * k, n - 3 * k, wm2, min(L, n - 3 * k));
+}
+
+// Bình phương trên mảng n block 64 bit, r có 2n block
+/*
+    @logic
+    a^2 = sum(a[i]^2 * B^(2i)) + 2 * sum(a[i] * a[j] * B^(i+j)), i < j
+    1. Tính các tích chéo a[i] * a[j] (i < j) đúng 1 lần
+    2. Nhân đôi bằng cách dịch trái 1 bit
+    3. Cộng các bình phương a[i]^2 trên đường chéo
+    --> khoảng n^2 / 2 phép nhân thay vì n^2
+*/
+void BigInt::square_limbs64(const uint64_t *x, size_t n, uint64_t *r)
+{
+    fill(r, r + 2 * n, 0);
+    // Tích chéo
+    for (size_t i = 0; i < n; i++)
+    {
+        uint64_t carry = 0;
+        for (size_t j = i + 1; j < n; j++)
+        {
+            uint128_t cur = (uint128_t)x[i] * x[j] + r[i + j] + carry;
+            r[i + j] = (uint64_t)cur;
+            carry = (uint64_t)(cur >> 64);
+        }
+        r[i + n] = carry;
     }
-    while (carry)
+    // Nhân đôi
+    uint64_t top = 0;
+    for (size_t i = 0; i < 2 * n; i++)
     {
-        result.data.push_back((uint32_t)(carry & 0xFFFFFFFF));
-        carry >>= 32;
+        uint64_t next = r[i] >> 63;
+        r[i] = (r[i] << 1) | top;
+        top = next;
     }
-    // loại bỏ block 0 dư
-    result.trim();
-    return result;
+    // Đường chéo
+    uint64_t carry = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        uint128_t sq = (uint128_t)x[i] * x[i];
+        uint128_t cur = (uint128_t)r[2 * i] + (uint64_t)sq + carry;
+        r[2 * i] = (uint64_t)cur;
+        cur = (uint128_t)r[2 * i + 1] + (uint64_t)(sq >> 64) + (uint64_t)(cur >> 64);
+        r[2 * i + 1] = (uint64_t)cur;
+        carry = (uint64_t)(cur >> 64);
+    }
+}
+
+// Bình phương
+/*
+    @param a (Số cần bình phương)
+    @logic
+    Giống karatsuba_multiply với a == b: mul_limbs64 nhận ra toán hạng trùng nhau và dùng
+    square_limbs64 ở tầng cuối, Karatsuba / Toom-3 cũng chỉ tính 1 tổng cho cả 2 toán hạng
+    --> các phép nhân con đều là bình phương.
+*/
+BigInt BigInt::square(const BigInt &a)
+{
+    DH_COUNT(SQR_CALLS, 1);
+    DH_COUNT(LIMBS_PROCESSED, (a.data.size() + 1) / 2);
+    if (a.data.empty())
+        return BigInt(0);
+    size_t n = (a.data.size() + 1) / 2;
+    LimbBuffer buf(n + 2 * n + mul_scratch_limbs(n));
+    uint64_t *x = buf.data(), *r = x + n;
+    to_limbs64(a, x, n);
+    mul_limbs64(x, n, x, n, r, r + 2 * n);
+    return from_limbs64(r, 2 * n);
 }
 
 // Toán tử nhân
@@ -376,85 +1247,145 @@ BigInt BigInt::operator*(const BigInt &other) const
 */
 BigInt BigInt::operator*(uint64_t small) const
 {
+    // Khi nhân vào, data sẽ tăng tối đa 2 block
     BigInt res;
-    if (small == 0)
-        return BigInt(0);
-
-    // Tách small thành 2 giá trị low và high, mỗi giá trị lần lượt chứa 32 bit thấp và 32 bit cao
-    uint32_t low = (uint32_t)(small);
-    uint32_t high = (uint32_t)(small >> 32);
+    res.data.reserve(data.size() + 2);
+    res.data.assign(data.begin(), data.end());
+    res *= small;
+    return res;
+}
 
-    // Khi nhân vào, data sẽ tăng tối đa 2 block
-    res.data.resize(data.size() + 2);
+// Toán tử chia
+BigInt BigInt::operator/(const BigInt &other) const
+{
+    BigInt quotient, remainder;
+    divmod(*this, other, quotient, remainder);
+    return quotient;
+}
 
-    uint64_t carry = 0; // Lưu giá trị nhớ từ phép toán với 64 bits sang 32 bits
-    for (size_t i = 0; i < data.size(); i++)
+// Phép chia lấy cả thương và dư (Knuth Algorithm D)
+/*
+    @param a (Số bị chia)
+    @param b (Số chia, khác 0)
+    @param quotient (Thương = a / b)
+    @param remainder (Dư = a % b)
+    @logic
+    1. Số chia chỉ có 1 block: chia từng block từ hàng cao xuống như chia tay, không cần chuẩn hóa
+    2. Chuẩn hóa: dịch trái a và b sao cho bit cao nhất của b bằng 1
+        --> ước lượng thương qhat từ 2 block cao nhất chỉ sai tối đa 2 đơn vị
+    3. Với mỗi vị trí j (từ cao xuống thấp):
+        a) qhat = (u[j+n]*B + u[j+n-1]) / v[n-1], chỉnh lại bằng block v[n-2]
+        b) u = u - qhat * v (nhân và trừ trong cùng 1 vòng lặp)
+        c) Nếu kết quả âm: qhat giảm 1 và cộng lại v
+    4. Dư là u sau khi dịch phải trở lại (bỏ chuẩn hóa)
+*/
+void BigInt::divmod(const BigInt &a, const BigInt &b, BigInt &quotient, BigInt &remainder)
+{
+    DH_COUNT(DIV_CALLS, 1);
+    DH_COUNT(LIMBS_PROCESSED, (a.data.size() + 1) / 2);
+    if (b.data.empty())
+        throw runtime_error("Division by zero!");
+    if (a < b)
     {
-        // Thực hiện nhân data[i] với low và high (nhân 2 số 32 bit sẽ sinh ra số tối đa 64 bit)
-        uint64_t p1 = (uint64_t)data[i] * low;
-        uint64_t p2 = (uint64_t)data[i] * high;
-
-        // Thực hiện theo thuật toán nhân 2 số không dấu
-
-        uint64_t sum = p1 + carry + res.data[i];
-        res.data[i] = (uint32_t)sum; // Lưu 32 bits thấp
-        carry = sum >> 32;           // Giữ 32 bits cao
-
-        uint64_t sum2 = (uint64_t)res.data[i + 1] + (p2 + (carry));
-        res.data[i + 1] = (uint32_t)sum2; // Lưu 32 bits thấp
-        carry = sum2 >> 32;               // Giữ 32 bits cao
+        quotient = BigInt(0);
+        remainder = a;
+        return;
     }
 
-    size_t idx = data.size();
+    size_t n = b.data.size();
+    size_t m = a.data.size() - n;
 
-    // Xử lý carry còn thừa
-    while (carry)
+    // Số chia 1 block
+    if (n == 1)
     {
-        if (idx >= res.data.size())
-            res.data.push_back((uint32_t)0); // Nếu còn thừa carry và các block đã full, tạo block mới
-
-        uint64_t sum = (uint64_t)res.data[idx] + carry;
-        res.data[idx] = (uint32_t)sum; // Lưu 32 bits thấp
-        carry = sum >> 32;             // Giữ 32 bits cao
-        idx++;
+        uint64_t d = b.data[0];
+        uint64_t rem = 0;
+        BigInt q;
+        q.data.resize(a.data.size());
+        for (int i = (int)a.data.size() - 1; i >= 0; i--)
+        {
+            uint64_t cur = (rem << 32) | a.data[i];
+            q.data[i] = (uint32_t)(cur / d);
+            rem = cur % d;
+        }
+        q.trim();
+        quotient = move(q);
+        remainder = BigInt(rem);
+        return;
     }
 
-    res.trim();
-    return res;
-}
+    // Chuẩn hóa: s = số bit 0 ở đầu block cao nhất của b
+    int s = 0;
+    while ((b.data.back() << s) < 0x80000000u)
+        s++;
+    LimbVector v, u;
+    v.resize(n);
+    u.resize(a.data.size() + 1);
+    for (size_t i = n - 1; i > 0; i--)
+        v[i] = (b.data[i] << s) | (s ? b.data[i - 1] >> (32 - s) : 0);
+    v[0] = b.data[0] << s;
+    u[a.data.size()] = s ? a.data.back() >> (32 - s) : 0;
+    for (size_t i = a.data.size() - 1; i > 0; i--)
+        u[i] = (a.data[i] << s) | (s ? a.data[i - 1] >> (32 - s) : 0);
+    u[0] = a.data[0] << s;
 
-// Toán tử chia
-BigInt BigInt::operator/(const BigInt &other) const
-{
-    if (other == BigInt(0))
-        throw runtime_error("Division by zero!");
-    BigInt quotient, remainder;
-    vector<uint32_t> quot_data;
-    quot_data.reserve(data.size());
-    remainder = BigInt(0);
-    for (int i = (int)data.size() - 1; i >= 0; i--)
+    BigInt q;
+    q.data.assign(m + 1, 0);
+    uint64_t v1 = v[n - 1], v2 = v[n - 2];
+    for (int j = (int)m; j >= 0; j--)
     {
-        remainder = remainder * BASE + BigInt((uint64_t)data[i]);
-        uint32_t q = 0, l = 0, r = 0xFFFFFFFFu;
-        while (l <= r)
+        // Ước lượng qhat từ 2 block cao nhất
+        uint64_t num = ((uint64_t)u[j + n] << 32) | u[j + n - 1];
+        uint64_t qhat = num / v1;
+        uint64_t rhat = num % v1;
+        while (qhat >= BASE || qhat * v2 > ((rhat << 32) | u[j + n - 2]))
+        {
+            qhat--;
+            rhat += v1;
+            if (rhat >= BASE)
+                break;
+        }
+
+        // u[j..j+n] = u[j..j+n] - qhat * v
+        int64_t borrow = 0;
+        uint64_t carry = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            uint64_t p = qhat * v[i] + carry;
+            carry = p >> 32;
+            int64_t t = (int64_t)u[i + j] - (int64_t)(p & 0xFFFFFFFF) + borrow;
+            u[i + j] = (uint32_t)t;
+            borrow = t >> 32;
+        }
+        int64_t t = (int64_t)u[j + n] - (int64_t)carry + borrow;
+        u[j + n] = (uint32_t)t;
+
+        // Trừ quá (xác suất rất nhỏ): cộng lại v
+        if (t < 0)
         {
-            uint32_t m = l + ((r - l) >> 1);
-            BigInt prod = other * BigInt((uint64_t)m);
-            if (!(remainder < prod))
+            qhat--;
+            carry = 0;
+            for (size_t i = 0; i < n; i++)
             {
-                q = m;
-                l = m + 1;
+                uint64_t sum = (uint64_t)u[i + j] + v[i] + carry;
+                u[i + j] = (uint32_t)sum;
+                carry = sum >> 32;
             }
-            else
-                r = m - 1;
+            u[j + n] += (uint32_t)carry;
         }
-        quot_data.push_back(q);
-        remainder = remainder - other * BigInt((uint64_t)q);
+        q.data[j] = (uint32_t)qhat;
     }
-    reverse(quot_data.begin(), quot_data.end());
-    quotient.data = quot_data;
-    quotient.trim();
-    return quotient;
+    q.trim();
+
+    // Bỏ chuẩn hóa phần dư
+    BigInt r;
+    r.data.resize(n);
+    for (size_t i = 0; i < n; i++)
+        r.data[i] = (u[i] >> s) | (s ? u[i + 1] << (32 - s) : 0);
+    r.trim();
+
+    quotient = move(q);
+    remainder = move(r);
 }
 
 // Thuật toán Barrett reduction (Barrett modulo)
@@ -469,12 +1400,20 @@ Các bước chính:
 */
 BigInt BigInt::barrett_mod(const BigInt &a, const BigInt &mod)
 {
+    DH_COUNT(REDUCE_CALLS, 1);
     // Nếu a < mod thì modulo chính là a
     if (a < mod)
         return a;
     
     // k = số lượng block uint32_t của mod
     size_t k = mod.data.size();
+    // Barrett chỉ đúng khi a < B^(2k), số lớn hơn thì chia trực tiếp
+    if (a.data.size() > 2 * k)
+    {
+        BigInt q, r;
+        divmod(a, mod, q, r);
+        return r;
+    }
     // Tạo số base_pow = B^(2k), B = 2^32
     BigInt base_pow(0);
     base_pow.data.assign(2 * k + 1, 0);
@@ -495,16 +1434,16 @@ BigInt BigInt::barrett_mod(const BigInt &a, const BigInt &mod)
     BigInt q1 = a >> shift1;
     // q2 = q1 * mu
     BigInt q2 = q1 * mu;
-    // q3 = q2 >> shift2 (lấy phần cao của q2)
-    BigInt q3 = q2 >> shift2;
+    // q3 = q2 >> shift2 (lấy phần cao của q2, dịch tại chỗ)
+    q2 >>= shift2;
     // r = a - q3 * mod
     // Đây là giá trị dư tạm thời, có thể >= mod
-    BigInt r = a - q3 * mod;
+    BigInt r = a - q2 * mod;
 
     // Nếu r >= mod, trừ mod cho đến khi r < mod
     while (!(r < mod))
     {
-        r = r - mod;
+        r -= mod;
     }
     // Trả về kết quả modulo
     return r;
@@ -521,11 +1460,58 @@ BigInt BigInt::operator%(const BigInt &mod) const
 }
 
 // Hàm nhân mod áp dụng thừa kế thuật toán barrett mod để tăng hiệu suất
-BigInt BigInt::mod_mul(BigInt a, BigInt b, const BigInt &mod)
+BigInt BigInt::mod_mul(const BigInt &a, const BigInt &b, const BigInt &mod)
 {
     return barrett_mod(a * b, mod);
 }
 
+// Hàm nhân mod dùng ngữ cảnh Montgomery
+/*
+    @logic
+    1. mul(a, b) = a * b * R^-1 mod p
+    2. Nhân tiếp với R^2 mod p: a * b * R^-1 * R^2 * R^-1 = a * b mod p
+    --> 2 lần CIOS, không có phép chia nào
+*/
+BigInt BigInt::mod_mul(const BigInt &a, const BigInt &b, const MontgomeryContext &ctx)
+{
+    size_t k = ctx.limbs();
+    LimbBuffer x(k, 0), y(k, 0), scratch(ctx.scratch_size());
+    BigInt ra = a < ctx.mod ? a : a % ctx.mod;
+    BigInt rb = b < ctx.mod ? b : b % ctx.mod;
+    to_limbs64(ra, x.data(), k);
+    to_limbs64(rb, y.data(), k);
+    ctx.mul(x.data(), y.data(), x.data(), scratch.data());
+    ctx.mul(x.data(), ctx.r2_mod.data(), x.data(), scratch.data());
+    return from_limbs64(x.data(), k);
+}
+
+// Gộp từng cặp block 32 bit thành 1 block 64 bit (k block 64 bit, phần thiếu là 0)
+void BigInt::to_limbs64(const BigInt &a, uint64_t *out, size_t k)
+{
+    fill(out, out + k, 0);
+    for (size_t i = 0; i < a.data.size() && i / 2 < k; i++)
+        out[i / 2] |= (uint64_t)a.data[i] << (32 * (i % 2));
+}
+
+// Tách k block 64 bit về lại các block 32 bit của BigInt
+BigInt BigInt::from_limbs64(const uint64_t *in, size_t k)
+{
+    BigInt result;
+    result.assign_limbs64(in, k);
+    return result;
+}
+
+void BigInt::assign_limbs64(const uint64_t *in, size_t k)
+{
+    data.resize(2 * k);
+    for (size_t i = 0; i < k; i++)
+    {
+        data[2 * i] = (uint32_t)in[i];
+        data[2 * i + 1] = (uint32_t)(in[i] >> 32);
+    }
+    trim();
+}
+
 // Toán tử dịch bit sang phải
 BigInt BigInt::operator>>(int shift) const
 {
@@ -577,109 +1563,605 @@ BigInt BigInt::operator>>(int shift) const
     return result;
 }
 
+// Dịch phải - gán (tại chỗ): block i nhận từ block i + full_blocks (đọc trước khi bị ghi đè)
+BigInt &BigInt::operator>>=(int shift)
+{
+    if (shift <= 0)
+        return *this;
+    size_t full_blocks = shift / 32;
+    int bit_shift = shift % 32;
+    if (full_blocks >= data.size())
+    {
+        data.resize(0);
+        return *this;
+    }
+    size_t n = data.size() - full_blocks;
+    for (size_t i = 0; i < n; i++)
+    {
+        uint64_t low = data[i + full_blocks];
+        uint64_t high = i + full_blocks + 1 < data.size() ? data[i + full_blocks + 1] : 0;
+        data[i] = (uint32_t)(((high << 32) | low) >> bit_shift);
+    }
+    data.resize(n);
+    trim();
+    return *this;
+}
+
+// Toán tử dịch bit sang trái
+BigInt BigInt::operator<<(int shift) const
+{
+    BigInt result;
+    result.data.reserve(data.size() + (shift > 0 ? shift / 32 : 0) + 1);
+    result.data.assign(data.begin(), data.end());
+    result <<= shift;
+    return result;
+}
+
+// Dịch trái - gán (tại chỗ): duyệt từ block cao xuống để không ghi đè block chưa đọc
+BigInt &BigInt::operator<<=(int shift)
+{
+    if (shift <= 0 || data.empty())
+        return *this;
+    size_t full_blocks = shift / 32;
+    int bit_shift = shift % 32;
+    size_t old_size = data.size();
+    data.resize(old_size + full_blocks + 1);
+    for (size_t i = old_size + full_blocks + 1; i-- > full_blocks;)
+    {
+        size_t src = i - full_blocks;
+        uint32_t high = src < old_size ? data[src] : 0;
+        uint32_t low = src >= 1 ? data[src - 1] : 0;
+        data[i] = bit_shift ? (high << bit_shift) | (low >> (32 - bit_shift)) : high;
+    }
+    fill(data.begin(), data.begin() + full_blocks, 0);
+    trim();
+    return *this;
+}
+
+// Số bit có nghĩa (0 với số 0)
+size_t BigInt::bit_length() const
+{
+    if (data.empty())
+        return 0;
+    size_t bits = (data.size() - 1) * 32;
+    uint32_t top = data.back();
+    while (top)
+    {
+        bits++;
+        top >>= 1;
+    }
+    return bits;
+}
+
+// Đọc bit thứ i (bit 0 là bit thấp nhất), ngoài phạm vi xem như 0
+bool BigInt::bit(size_t i) const
+{
+    size_t block = i / 32;
+    if (block >= data.size())
+        return false;
+    return (data[block] >> (i % 32)) & 1;
+}
+
 // Xuất
 /*
     @param os (luồng xuất)
     @param number (Số BigInt cần xuất ra màn hình)
     @logic
-    1. Nếu number.data rỗng --> Số 0
-    2. Ý tưởng chính: Chia liên tục cho 10 và lấy phần dư làm chữ số
-    3. Chuyển chữ số này sang chuỗi decString để xuất ra màn hình
+    1. Ghi các chữ số vào 1 string có sẵn độ dài decimal_size() (to_decimal)
+    2. Xuất string ra luồng
 */
 ostream &operator<<(ostream &os, const BigInt &number)
 {
-    if (number.data.empty())
+    return os << number.to_string();
+}
+
+// Chuyển đổi cơ số
+struct BigInt::Pow10Level
+{
+    BigInt power; // 10^(9 * 2^i)
+    BigInt mu;    // floor(B^(2k) / power), k = số block của power
+};
+
+/*
+    @param i (Bậc: power = 10^(9 * 2^i))
+    @logic
+    1. power[0] = 10^9, power[i] = power[i - 1]^2
+    2. mu tính 1 lần bằng phép chia (như barrett_mod), các lần tách sau chỉ còn phép nhân
+    3. Cache theo thread, tách khỏi arena (detach) vì bảng sống lâu hơn mọi Scope
+    deque: thêm bậc mới không làm mất hiệu lực tham chiếu đến các bậc cũ
+*/
+const BigInt::Pow10Level &BigInt::pow10_level(size_t i)
+{
+    thread_local deque<Pow10Level> levels;
+    while (levels.size() <= i)
     {
-        return os << 0;
+        BigInt power = levels.empty() ? BigInt(1000000000) : square(levels.back().power);
+        BigInt base_pow;
+        base_pow.data.assign(2 * power.data.size() + 1, 0);
+        base_pow.data[2 * power.data.size()] = 1;
+        BigInt mu = base_pow / power;
+        levels.push_back({LimbArena::detach(power), LimbArena::detach(mu)});
     }
-    BigInt temp = number;
-    string decString;
-    while (!(temp == BigInt(0)))
-    {
-        BigInt q;         // Thương
-        uint64_t rem = 0; // Số dư
-        q.data.resize(temp.data.size());
-
-        /*
-            Giống như chia tay, ta xét từ hàng lớn nhất chia trước
-            1. Ví dụ với hệ cơ số 10: BASE = 10
-            2. rem << 32 --> Số dư từ bước trước dịch trái 32 bit (Nghĩa là nhân với BASE)
-        */
-        for (int i = (int)temp.data.size() - 1; i >= 0; --i)
-        {
-            uint64_t cur = (rem << 32) + temp.data[i];
-            q.data[i] = (uint32_t)(cur / 10);
-            rem = cur % 10;
-        }
+    return levels[i];
+}
 
-        /*
-            q = [2, 5]
-            decString = "3"
-            temp = [2, 5]
-            Tiếp tục thực hiện lại
-        */
-        q.trim();
-        decString.push_back('0' + rem);
-        temp = q;
+// Barrett với mu dựng sẵn: q ước lượng thiếu tối đa 2, sửa bằng vài phép trừ
+void BigInt::divmod_pow10(const BigInt &a, const Pow10Level &level, BigInt &q, BigInt &r)
+{
+    size_t k = level.power.data.size();
+    q = a >> (int)((k - 1) * 32);
+    q *= level.mu;
+    q >>= (int)((k + 1) * 32);
+    r = a - q * level.power;
+    while (!(r < level.power))
+    {
+        r -= level.power;
+        q += 1;
     }
-    /*
-        Sau vòng lặp: decString = "325"
-        Reverse --> decString = "523"
-    */
-    reverse(decString.begin(), decString.end());
-    os << decString;
-    return os;
 }
 
-// Toán tử mod_exp
 /*
-    @param base (Cơ số)
-    @param exp (Số mũ)
-    @param mod (Số mod)
-    @return base^exp % mod
     @logic
-    1. Ý tưởng chính: Phương pháp bình phương và nhân
-    2. Nếu exp = 13 = 1101₂ = 2³ + 2² + 2⁰ = 8 + 4 + 1
-    --> base^13 = base^(8+4+1) = base^8 × base^4 × base^1
-    3. Áp dụng thuật toán Barrett Mod để tối ưu hơn
+    1. Số nhỏ: chia tại chỗ cho 10^9 (div_small), chunk cao nhất in không có số 0 ở đầu,
+    các chunk còn lại in đủ 9 chữ số
+    2. Số lớn: chọn i nhỏ nhất để x < 10^(9 * 2^i), tách x = q * 10^(9 * 2^(i-1)) + r
+    --> in q (không đệm) rồi r (đệm đủ 9 * 2^(i-1) chữ số)
+    Mỗi tầng là phép nhân (Karatsuba / Toom-3) trên số dài gấp đôi --> dưới bình phương
 */
-BigInt BigInt::modular_exponentiation(BigInt base, BigInt exp, const BigInt &mod)
+size_t BigInt::put_decimal(const BigInt &x, char *out)
 {
-    BigInt result(1);
-    base = base % mod; // Tính chất: (a % m)^n % m = a^n % m
-    while (!(exp == BigInt(0)))
+    if (x.data.size() <= RADIX_DC_LIMBS)
     {
-        // Xét exp % 2 == 1 (Kiểm tra bit cuối nếu là 1 thì là số lẻ)
-        // Nếu exp lẻ: base^exp = base × base^(exp-1)
-        if (!exp.data.empty() && (exp.data[0] & 1))
+        // 10^9 > 2^29 --> số chunk <= 32 * số block / 29 + 1
+        uint32_t chunks[RADIX_DC_LIMBS * 32 / 29 + 1];
+        size_t m = 0;
+        BigInt temp = x;
+        while (!temp.is_zero())
+            chunks[m++] = temp.div_small(1000000000);
+        if (m == 0)
         {
-            result = barrett_mod(result * base, mod);
+            out[0] = '0';
+            return 1;
         }
-        // Chuẩn bị base cho bước tiếp theo
-        /*
-        Ví dụ:
-            base = 2
-            base = 2^2 = 4
-            base = 4^2 = 16
-            base = 16^2 = 256
-        */
-        base = barrett_mod(base * base, mod);
-        uint64_t carry = 0;
-        for (int i = exp.data.size() - 1; i >= 0; i--)
+        char top[10];
+        size_t len = 0;
+        for (uint32_t v = chunks[m - 1]; v; v /= 10)
+            top[len++] = '0' + v % 10;
+        size_t n = 0;
+        while (len)
+            out[n++] = top[--len];
+        for (size_t j = m - 1; j-- > 0; n += 9)
         {
-            uint64_t cur = (carry << 32) + exp.data[i];
-            exp.data[i] = (uint32_t)(cur / 2);
-            carry = cur % 2;
+            uint32_t v = chunks[j];
+            for (int d = 8; d >= 0; d--, v /= 10)
+                out[n + d] = '0' + v % 10;
         }
-        exp.trim();
+        return n;
     }
+    size_t i = 1;
+    while (!(x < pow10_level(i).power))
+        i++;
+    BigInt q, r;
+    divmod_pow10(x, pow10_level(i - 1), q, r);
+    size_t n = put_decimal(q, out);
+    put_decimal_padded(r, i - 1, out + n);
+    return n + ((size_t)9 << (i - 1));
+}
 
-    return result;
+void BigInt::put_decimal_padded(const BigInt &x, size_t i, char *out)
+{
+    size_t width = (size_t)9 << i;
+    if (x.data.size() <= RADIX_DC_LIMBS)
+    {
+        // Ghi từ phải sang trái, hết số thì phần còn lại là chữ số 0
+        BigInt temp = x;
+        for (size_t end = width; end > 0; end -= 9)
+        {
+            uint32_t v = temp.is_zero() ? 0 : temp.div_small(1000000000);
+            for (int d = 1; d <= 9; d++, v /= 10)
+                out[end - d] = '0' + v % 10;
+        }
+        return;
+    }
+    BigInt q, r;
+    divmod_pow10(x, pow10_level(i - 1), q, r);
+    put_decimal_padded(q, i - 1, out);
+    put_decimal_padded(r, i - 1, out + width / 2);
 }
 
 /*
     @logic
-    1. Sinh một số BigInt ngẫu nhiên với đúng 'bits' bit
+    1. Chuỗi ngắn: gom 9 chữ số rồi out = out * 10^9 + chunk (mul_add_small)
+    2. Chuỗi dài: w = 9 * 2^i lớn nhất mà w < n, tách thành phần cao (n - w chữ số) và phần thấp (w chữ số)
+    --> out = cao * 10^w + thấp
+*/
+void BigInt::parse_decimal(const char *s, size_t n, BigInt &out)
+{
+    if (n <= RADIX_DC_LIMBS * 9)
+    {
+        out.data.resize(0);
+        uint32_t chunk = 0, scale = 1;
+        for (size_t j = 0; j < n; j++)
+        {
+            chunk = chunk * 10 + (uint32_t)(s[j] - '0');
+            scale *= 10;
+            if (scale == 1000000000)
+            {
+                out.mul_add_small(scale, chunk);
+                chunk = 0;
+                scale = 1;
+            }
+        }
+        if (scale > 1)
+            out.mul_add_small(scale, chunk);
+        return;
+    }
+    size_t i = 0;
+    while (((size_t)9 << (i + 1)) < n)
+        i++;
+    size_t w = (size_t)9 << i;
+    BigInt high, low;
+    parse_decimal(s, n - w, high);
+    parse_decimal(s + n - w, w, low);
+    multiply_to(high, pow10_level(i).power, out);
+    out += low;
+}
+
+// Cận trên số chữ số: bits * log10(2) + 1 (30103 / 100000 > log10(2))
+size_t BigInt::decimal_size() const
+{
+    return bit_length() * 30103 / 100000 + 1;
+}
+
+size_t BigInt::hex_size() const
+{
+    return data.empty() ? 1 : data.size() * 8;
+}
+
+size_t BigInt::to_decimal(char *buf, size_t cap) const
+{
+    if (cap < decimal_size())
+        throw runtime_error("Buffer too small for decimal output!");
+    // Thương / dư trung gian chỉ sống trong lần chuyển đổi
+    LimbArena::Scope scope;
+    return put_decimal(*this, buf);
+}
+
+// Mỗi block 32 bit là đúng 8 chữ số hex --> tuyến tính, block cao nhất bỏ số 0 ở đầu
+size_t BigInt::to_hex(char *buf, size_t cap) const
+{
+    static const char digits[] = "0123456789abcdef";
+    if (cap < hex_size())
+        throw runtime_error("Buffer too small for hex output!");
+    if (data.empty())
+    {
+        buf[0] = '0';
+        return 1;
+    }
+    size_t n = 0;
+    uint32_t top = data[data.size() - 1];
+    int shift = 28;
+    while (shift > 0 && (top >> shift) == 0)
+        shift -= 4;
+    for (; shift >= 0; shift -= 4)
+        buf[n++] = digits[(top >> shift) & 0xF];
+    for (size_t i = data.size() - 1; i-- > 0;)
+    {
+        for (shift = 28; shift >= 0; shift -= 4)
+            buf[n++] = digits[(data[i] >> shift) & 0xF];
+    }
+    return n;
+}
+
+string BigInt::to_string() const
+{
+    string s(decimal_size(), '\0');
+    s.resize(to_decimal(&s[0], s.size()));
+    return s;
+}
+
+string BigInt::to_hex_string() const
+{
+    string s(hex_size(), '\0');
+    s.resize(to_hex(&s[0], s.size()));
+    return s;
+}
+
+/*
+    @param s, n (Chuỗi thập phân và độ dài)
+    @logic
+    1. Đặt trước dung lượng cho data theo số chữ số (9 chữ số < 1 block) ngoài mọi Scope
+    2. Chuỗi ngắn: đọc thẳng vào data
+    3. Chuỗi dài: chia để trị trong Scope, chép kết quả vào data (vừa dung lượng đã đặt)
+*/
+BigInt &BigInt::assign_decimal(const char *s, size_t n)
+{
+    size_t digits = count_if(s, s + n, [](char c)
+                             { return isdigit(c); });
+    data.resize(0);
+    data.reserve(digits / 9 + 1);
+    if (digits <= RADIX_DC_LIMBS * 9 || digits != n)
+    {
+        // Ngắn, hoặc có ký tự lạ cần bỏ qua: gom chunk 10^9 trực tiếp
+        if (digits <= RADIX_DC_LIMBS * 9)
+        {
+            uint32_t chunk = 0, scale = 1;
+            for (size_t j = 0; j < n; j++)
+            {
+                if (!isdigit(s[j]))
+                    continue;
+                chunk = chunk * 10 + (uint32_t)(s[j] - '0');
+                scale *= 10;
+                if (scale == 1000000000)
+                {
+                    mul_add_small(scale, chunk);
+                    chunk = 0;
+                    scale = 1;
+                }
+            }
+            if (scale > 1)
+                mul_add_small(scale, chunk);
+            return *this;
+        }
+        string filtered;
+        filtered.reserve(digits);
+        for (size_t j = 0; j < n; j++)
+            if (isdigit(s[j]))
+                filtered.push_back(s[j]);
+        return assign_decimal(filtered.data(), filtered.size());
+    }
+    LimbArena::Scope scope;
+    BigInt result;
+    parse_decimal(s, n, result);
+    data.assign(result.data.begin(), result.data.end());
+    return *this;
+}
+
+// Mỗi chữ số hex là 4 bit: ghi thẳng vào block từ chữ số thấp nhất, bỏ qua ký tự lạ (kể cả "0x")
+BigInt &BigInt::assign_hex(const char *s, size_t n)
+{
+    size_t digits = count_if(s, s + n, [](char c)
+                             { return isxdigit(c); });
+    data.resize(0);
+    data.resize((digits + 7) / 8);
+    size_t j = 0;
+    for (size_t i = n; i-- > 0;)
+    {
+        char c = s[i];
+        if (!isxdigit(c))
+            continue;
+        uint32_t v = isdigit(c) ? c - '0' : (tolower(c) - 'a' + 10);
+        data[j / 8] |= v << (4 * (j % 8));
+        j++;
+    }
+    trim();
+    return *this;
+}
+
+BigInt BigInt::from_hex(const string &hexString)
+{
+    BigInt result;
+    result.assign_hex(hexString.data(), hexString.size());
+    return result;
+}
+
+// Mã hóa nhị phân
+size_t BigInt::byte_length() const
+{
+    return (bit_length() + 7) / 8;
+}
+
+/*
+    @param out, len (Bộ đệm đích đúng len byte)
+    @param order (Thứ tự byte)
+    @logic
+    1. Byte thứ j tính từ byte thấp nhất = (data[j / 4] >> 8 * (j % 4)) & 0xFF
+    2. BIG: byte j nằm ở out[len - 1 - j]; LITTLE: nằm ở out[j]
+    3. Phần còn lại (byte cao hơn số) là 0
+*/
+void BigInt::to_bytes(uint8_t *out, size_t len, ByteOrder order) const
+{
+    if (byte_length() > len)
+        throw runtime_error("Buffer too small for byte encoding!");
+    size_t n = min(len, data.size() * 4);
+    if (order == ByteOrder::BIG)
+    {
+        for (size_t j = 0; j < n; j++)
+            out[len - 1 - j] = (uint8_t)(data[j / 4] >> (8 * (j % 4)));
+        fill(out, out + (len - n), 0);
+    }
+    else
+    {
+        for (size_t j = 0; j < n; j++)
+            out[j] = (uint8_t)(data[j / 4] >> (8 * (j % 4)));
+        fill(out + n, out + len, 0);
+    }
+}
+
+BigInt &BigInt::assign_bytes(const uint8_t *in, size_t len, ByteOrder order)
+{
+    data.resize(0);
+    data.resize((len + 3) / 4);
+    for (size_t j = 0; j < len; j++)
+    {
+        uint8_t b = order == ByteOrder::BIG ? in[len - 1 - j] : in[j];
+        data[j / 4] |= (uint32_t)b << (8 * (j % 4));
+    }
+    trim();
+    return *this;
+}
+
+BigInt BigInt::from_bytes(const uint8_t *in, size_t len, ByteOrder order)
+{
+    BigInt result;
+    result.assign_bytes(in, len, order);
+    return result;
+}
+
+void BigInt::to_bytes_batch(const vector<BigInt> &values, uint8_t *out, size_t width, ByteOrder order)
+{
+    for (size_t i = 0; i < values.size(); i++)
+        values[i].to_bytes(out + i * width, width, order);
+}
+
+void BigInt::from_bytes_batch(const uint8_t *in, size_t width, size_t count, vector<BigInt> &values, ByteOrder order)
+{
+    values.resize(count);
+    for (size_t i = 0; i < count; i++)
+        values[i].assign_bytes(in + i * width, width, order);
+}
+
+// Toán tử mod_exp
+/*
+    @param base (Cơ số)
+    @param exp (Số mũ)
+    @param mod (Số mod)
+    @return base^exp % mod
+    @logic
+    1. Ý tưởng chính: Phương pháp bình phương và nhân
+    2. Nếu exp = 13 = 1101₂ = 2³ + 2² + 2⁰ = 8 + 4 + 1
+    --> base^13 = base^(8+4+1) = base^8 × base^4 × base^1
+    3. Áp dụng thuật toán Barrett Mod để tối ưu hơn
+    4. Duyệt bit của exp từ cao xuống thấp theo cửa sổ trượt (xem MontgomeryContext::pow),
+    đọc bit trực tiếp bằng exp.bit(i) thay vì chia đôi exp sau mỗi bước
+*/
+BigInt BigInt::modular_exponentiation(const BigInt &base, const BigInt &exp, const BigInt &mod)
+{
+    DH_TIME(MODEXP);
+    // Số tạm cấp phát từ arena của thread, thu hồi 1 lần khi trả về
+    LimbArena::Scope scope;
+    // Modulus lẻ (trường hợp của mọi số nguyên tố p > 2): dùng Montgomery
+    if (mod.is_odd() && mod > 1)
+    {
+        MontgomeryContext ctx(mod);
+        return modular_exponentiation(base, exp, ctx);
+    }
+
+    BigInt result(1);
+    BigInt reduced = base % mod; // Tính chất: (a % m)^n % m = a^n % m
+    size_t nbits = exp.bit_length();
+    if (nbits == 0)
+        return LimbArena::detach(result %= mod);
+
+    // Bảng lũy thừa lẻ: table[i] = base^(2i+1) (cả vector bảng cũng nằm trong arena)
+    int w = window_width(nbits);
+    vector<BigInt, ArenaAllocator<BigInt>> table(1 << (w - 1));
+    table[0] = reduced;
+    BigInt base_sq = barrett_mod(square(reduced), mod);
+    for (size_t i = 1; i < table.size(); i++)
+        table[i] = barrett_mod(table[i - 1] * base_sq, mod);
+
+    // Mỗi bước tính trong 1 Scope riêng rồi chép (không move) vào result, dung lượng của result
+    // đã đặt trước ngoài Scope --> bộ nhớ arena không tăng theo số bit của exp
+    result.data.reserve(mod.data.size() + 1);
+    auto square_step = [&]()
+    {
+        LimbArena::Scope step;
+        BigInt next = barrett_mod(square(result), mod);
+        result = next;
+    };
+    auto mul_step = [&](const BigInt &factor)
+    {
+        LimbArena::Scope step;
+        BigInt next = barrett_mod(result * factor, mod);
+        result = next;
+    };
+
+    bool started = false;
+    int i = (int)nbits - 1;
+    while (i >= 0)
+    {
+        // Bit 0: chỉ bình phương
+        if (!exp.bit(i))
+        {
+            square_step();
+            i--;
+            continue;
+        }
+        // Cửa sổ [l, i] dài tối đa w bit, kết thúc bằng bit 1
+        int l = max(i - w + 1, 0);
+        while (!exp.bit(l))
+            l++;
+        uint32_t value = 0;
+        for (int j = i; j >= l; j--)
+            value = (value << 1) | (uint32_t)exp.bit(j);
+
+        if (started)
+        {
+            for (int j = i; j >= l; j--)
+                square_step();
+            mul_step(table[value >> 1]);
+        }
+        else
+        {
+            result = table[value >> 1];
+            started = true;
+        }
+        i = l - 1;
+    }
+
+    return LimbArena::detach(result);
+}
+
+// Hàm modular_exponentiation với ngữ cảnh Montgomery
+/*
+    @logic
+    1. Đưa base về dạng Montgomery (1 lần nhân với R^2)
+    2. Bình phương và nhân hoàn toàn trong dạng Montgomery
+    3. Đưa kết quả về dạng thường
+    Bộ đệm tạm lấy từ arena của thread (LimbArena::Scope), chỉ kết quả được chép ra heap
+*/
+BigInt BigInt::modular_exponentiation(const BigInt &base, const BigInt &exp, const MontgomeryContext &ctx)
+{
+    DH_TIME(MODEXP_MONTGOMERY);
+    LimbArena::Scope scope;
+    return LimbArena::detach(ctx.from_mont(ctx.pow(ctx.to_mont(base), exp)));
+}
+
+// Hàm modular_exponentiation thời gian hằng (số mũ bí mật)
+/*
+    @logic
+    Giống bản Montgomery nhưng lũy thừa bằng pow_consttime; base, modulus coi là công khai
+    (khóa công khai của bên kia, số nguyên tố p), chỉ exp được giữ kín.
+*/
+BigInt BigInt::modular_exponentiation_consttime(const BigInt &base, const BigInt &exp, const BigInt &mod)
+{
+    if (!mod.is_odd() || mod < 3)
+        throw runtime_error("Constant-time modular exponentiation requires an odd modulus!");
+    LimbArena::Scope scope;
+    MontgomeryContext ctx(mod);
+    return modular_exponentiation_consttime(base, exp, ctx);
+}
+
+BigInt BigInt::modular_exponentiation_consttime(const BigInt &base, const BigInt &exp, const MontgomeryContext &ctx)
+{
+    DH_TIME(MODEXP_CONSTTIME);
+    LimbArena::Scope scope;
+    return LimbArena::detach(ctx.from_mont(ctx.pow_consttime(ctx.to_mont(base), exp)));
+}
+
+// Độ rộng cửa sổ theo độ dài số mũ
+/*
+    @logic
+    Cửa sổ w bit cần 2^(w-1) lũy thừa lẻ dựng trước và khoảng n/(w+1) phép nhân.
+    Chọn w nhỏ nhất sao cho chi phí dựng bảng không vượt phần nhân tiết kiệm được.
+*/
+int BigInt::window_width(size_t exp_bits)
+{
+    if (exp_bits > 671)
+        return 6;
+    if (exp_bits > 239)
+        return 5;
+    if (exp_bits > 79)
+        return 4;
+    if (exp_bits > 23)
+        return 3;
+    return 1;
+}
+
+/*
+    @logic
+    1. Sinh một số BigInt ngẫu nhiên với đúng 'bits' bit
     2. Tính số block cần thiết (mỗi block = 32 bit) để chứa đủ bits
     3. Sinh ngẫu nhiên từng block uint32_t bằng mt19937_64
     4. Xử lý các bit thừa trong block cuối cùng để đảm bảo độ dài chính xác
@@ -687,18 +2169,30 @@ BigInt BigInt::modular_exponentiation(BigInt base, BigInt exp, const BigInt &mod
     6. Đặt bit thấp nhất (LSB) là 1 để số lẻ (thường dùng trong prime generation)
     7. Loại bỏ các block 0 dư thừa (trim)
 */
+// Khởi tạo generator ngẫu nhiên (1 lần cho mỗi thread)
+// Seed theo time(nullptr) ở mỗi lần gọi sẽ trả về cùng 1 số trong cùng 1 giây
+mt19937_64 &BigInt::rng()
+{
+    static thread_local mt19937_64 gen(random_device{}() ^ (uint64_t)time(nullptr));
+    return gen;
+}
+
+void BigInt::seed_random(uint64_t seed)
+{
+    rng().seed(seed);
+}
+
 BigInt BigInt::random_bits(int bits)
 {
     BigInt result(0);
     // Tính số block cần dùng (mỗi block = 32 bit)
     int blocks = (bits + 31) / 32;
-    // Khởi tạo generator ngẫu nhiên
-    mt19937_64 rng((unsigned)time(nullptr));
+    mt19937_64 &gen = rng();
     // Cấp phát memory cho số
     result.data.resize(blocks);
     // Sinh ngẫu nhiên từng block
     for (int i = 0; i < blocks; i++)
-        result.data[i] = (uint32_t)(rng() & 0xFFFFFFFFULL);
+        result.data[i] = (uint32_t)(gen() & 0xFFFFFFFFULL);
     
     // Xử lý các bit thừa trong block cuối cùng (chỉ giữ đúng số bit cần)
     int extra_bits = blocks * 32 - bits;
@@ -737,10 +2231,12 @@ BigInt BigInt::random_bits(int bits)
 */
 bool BigInt::is_prime_by_Miller_Rabin(const BigInt &n, int iterations)
 {
+    DH_TIME(MILLER_RABIN);
+    LimbArena::Scope scope;
     // Kiểm tra trường hợp nhỏ
-    if (n == BigInt(2) || n == BigInt(3))
+    if (n == 2 || n == 3)
         return true;
-    if (n < BigInt(2))
+    if (n < 2)
         return false;
     if (n.data.empty())
         return false;
@@ -750,121 +2246,1898 @@ bool BigInt::is_prime_by_Miller_Rabin(const BigInt &n, int iterations)
     // Viết n-1 = 2^s * d, với d lẻ
     BigInt d = n - BigInt(1);
     int s = 0;
-    while (!d.data.empty() && (d.data[0] & 1) == 0)
-    {
-        uint64_t carry = 0;
-        for (int i = (int)d.data.size() - 1; i >= 0; --i)
-        {
-            uint64_t cur = (carry << 32) + d.data[i];
-            d.data[i] = (uint32_t)(cur >> 1);
-            carry = cur & 1;
-        }
-        d.trim();
+    while (!d.bit(s))
         s++;
-    }
-    // Khởi tạo random generator
-    mt19937_64 rng((unsigned)time(nullptr));
+    d >>= s;
+    // Dựng ngữ cảnh Montgomery 1 lần cho tất cả các vòng thử
+    // So sánh trực tiếp trong dạng Montgomery: 1 -> R mod n, n-1 -> n - (R mod n)
+    MontgomeryContext ctx(n);
+    LimbBuffer scratch(ctx.scratch_size());
+    LimbBuffer minus_one_m = ctx.to_mont(n - BigInt(1));
+
+    // Bộ sinh ngẫu nhiên riêng của thread (không seed lại theo giây
+    // --> các lần gọi trong cùng 1 giây không lặp lại cùng dãy cơ số)
+    mt19937_64 &gen = rng();
     uniform_int_distribution<uint64_t> dist;
 
     // Lặp kiểm tra iterations lần
     for (int i = 0; i < iterations; i++)
     {
+        // Số tạm của mỗi vòng thử được thu hồi ngay cuối vòng
+        LimbArena::Scope round;
         // Chọn a ngẫu nhiên: 2 <= a <= n-2
-        BigInt a = BigInt(dist(rng)) % (n - BigInt(4)) + BigInt(2);
-        // Tính x = a^d % n
-        BigInt x = modular_exponentiation(a, d, n);
-        // Nếu x == 1 hoặc x == n-1, a hợp lệ → tiếp tục vòng thử khác
-        if (x == BigInt(1) || x == n - BigInt(1))
-            continue;
-        // Lặp kiểm tra các bình phương của x
-        bool cont = false;
-        for (int r = 0; r < s - 1; r++)
-        {
-            // x = x^2 % n
-            x = modular_exponentiation(x, BigInt(2), n);
-            if (x == n - BigInt(1))
-            {
-                // a hợp lệ
-                cont = true;
-                break;
-            }
-        }
-
-        // Nếu không có x nào == n-1, n không phải prime
-        if (cont)
-            continue;
-        return false;
+        BigInt a = BigInt(dist(gen)) % (n - 4) + 2;
+        if (!miller_rabin_round(ctx, ctx.to_mont(a), d, s, minus_one_m, scratch.data()))
+            return false;
     }
 
     // Nếu qua tất cả iterations thì kết thúc hàm
     return true;
 }
 
-// Hàm tạo số nguyên tố
+// 1 vòng Miller-Rabin (kiểm tra số nguyên tố mạnh theo cơ số a)
 /*
+    @param a_m (Cơ số a, dạng Montgomery)
+    @param d, s (n - 1 = 2^s * d, d lẻ)
+    @param minus_one_m (n - 1 dạng Montgomery)
+    @return false: chắc chắn là hợp số; true: n là số nguyên tố mạnh theo cơ số a
     @logic
-    1. Tạo 1 số nguyên tố từ hàm random_bits
-    2. Kiểm tra lại xem tính chính xác của số nguyên tố p
+    1. x = a^d mod n; x == 1 hoặc x == n - 1 --> qua
+    2. Bình phương x tối đa s - 1 lần, gặp n - 1 --> qua; ngược lại là hợp số
 */
-BigInt BigInt::generate_prime(int bits)
+bool BigInt::miller_rabin_round(const MontgomeryContext &ctx, const LimbBuffer &a_m, const BigInt &d, int s,
+                                const LimbBuffer &minus_one_m, uint64_t *scratch)
 {
-    while (true)
+    DH_COUNT(MR_ROUNDS, 1);
+    LimbBuffer x = ctx.pow(a_m, d);
+    if (x == ctx.one() || x == minus_one_m)
+        return true;
+    for (int r = 0; r < s - 1; r++)
     {
-        BigInt p = random_bits(bits);
-        if (is_prime_by_Miller_Rabin(p))
-            return p;
+        ctx.sqr(x.data(), x.data(), scratch);
+        if (x == minus_one_m)
+            return true;
     }
+    return false;
 }
 
-// Hàm tạo số nguyên tố an toàn
+// Hàm kiểm tra số nguyên tố Baillie-PSW
 /*
     @logic
-    1. Sinh một số nguyên tố q (bits-1 bit) bằng Miller-Rabin
-    2. Tạo p = 2*q + 1
-    3. Kiểm tra p có phải là số nguyên tố bằng Miller-Rabin
-    4. Nếu đúng, p là safe prime (vì (p-1)/2 = q cũng là prime)
+    1. Chia thử cho các số nguyên tố nhỏ (< 1000): loại nhanh và xử lý n nhỏ
+    2. Miller-Rabin với cơ số 2 (1 phép lũy thừa)
+    3. Chọn D theo Selfridge: D = 5, -7, 9, -11, ... đầu tiên có (D / n) = -1
+        - (D / n) = 0 với |D| < n: n có ước chung với D --> hợp số
+        - Không tìm thấy D sau vài lần thử: n có thể là số chính phương (khi đó không tồn tại D) --> kiểm tra
+    4. Kiểm tra Lucas mạnh với P = 1, Q = (1 - D) / 4
+    Chưa có hợp số nào qua được cả 2 bước 2 và 4 (đã kiểm chứng với mọi n < 2^64);
+    các số giả nguyên tố mạnh cơ số 2 và số giả nguyên tố Lucas mạnh là 2 tập gần như tách rời.
+    Chi phí ~ 1 lũy thừa + 1 dãy Lucas (khoảng 3 lũy thừa), so với 7 lũy thừa của is_prime_by_Miller_Rabin
 */
-BigInt BigInt::generate_safe_prime(int bits)
+bool BigInt::is_prime_by_Baillie_PSW(const BigInt &n)
 {
-    int q_bits = bits - 1;
-    while (true)
+    DH_TIME(BAILLIE_PSW);
+    if (n < 2)
+        return false;
+    for (uint32_t p : small_primes())
     {
-        BigInt q = BigInt::generate_prime(q_bits);
-        BigInt p = q * 2 + 1;
-        if (BigInt::is_prime_by_Miller_Rabin(p, 7))
+        if (p >= 1000)
+            break;
+        if (n == p)
+            return true;
+        if (n.mod_small(p) == 0)
+            return false;
+    }
+    if (n == 2)
+        return true;
+    if (!n.is_odd())
+        return false;
+    // Không có ước < 1000 --> n < 1000^2 là số nguyên tố
+    if (n < 1000000)
+        return true;
+
+    LimbArena::Scope scope;
+    MontgomeryContext ctx(n);
+    BigInt n_minus_1 = n - 1;
+    BigInt d = n_minus_1;
+    int s = 0;
+    while (!d.bit(s))
+        s++;
+    d >>= s;
+    {
+        LimbBuffer scratch(ctx.scratch_size());
+        if (!miller_rabin_round(ctx, ctx.to_mont(BigInt(2)), d, s, ctx.to_mont(n_minus_1), scratch.data()))
+            return false;
+    }
+
+    // (-1 / n) = 1 khi n mod 4 = 1, ngược lại -1
+    int minus_one_symbol = (n.data[0] & 3) == 1 ? 1 : -1;
+    int64_t D = 5;
+    for (int attempt = 0;; attempt++)
+    {
+        int64_t abs_d = D < 0 ? -D : D;
+        int symbol = jacobi(BigInt((uint64_t)abs_d), n);
+        if (D < 0)
+            symbol *= minus_one_symbol;
+        if (symbol == -1)
+            break;
+        if (symbol == 0 && n > (uint64_t)abs_d)
+            return false;
+        if (attempt == 5)
         {
-            return p;
+            BigInt r = isqrt(n);
+            if (r * r == n)
+                return false;
         }
+        D = D < 0 ? -D + 2 : -(D + 2);
     }
-};
+    return is_strong_lucas_probable_prime(n, ctx, D);
+}
 
-// Hàm sinh khóa riêng trong khoảng [2, p−2]
-BigInt BigInt::generate_private_key(BigInt p)
+// Kiểm tra Lucas mạnh
+/*
+    @param D (Tham số Selfridge, (D / n) = -1), P = 1, Q = (1 - D) / 4
+    @logic
+    1. n + 1 = 2^s * d, d lẻ
+    2. Tính U_d, V_d, Q^d mod n theo bit của d từ cao xuống thấp (dạng Montgomery):
+        - Nhân đôi: U_2k = U_k * V_k, V_2k = V_k^2 - 2Q^k, Q^2k = (Q^k)^2
+        - Cộng 1:   U_k+1 = (P * U_k + V_k) / 2, V_k+1 = (D * U_k + P * V_k) / 2, Q^k+1 = Q^k * Q
+        (D, Q nhỏ: nhân bằng nhân đôi và cộng, không dùng phép nhân Montgomery)
+        (chia 2 mod n: cộng n nếu lẻ rồi dịch phải, giữ nguyên dạng Montgomery vì tuyến tính)
+    3. n là số giả nguyên tố Lucas mạnh nếu U_d = 0 hoặc V_(d * 2^r) = 0 với 0 <= r < s
+*/
+bool BigInt::is_strong_lucas_probable_prime(const BigInt &n, const MontgomeryContext &ctx, int64_t D)
 {
-    if (p < BigInt(5))
+    LimbArena::Scope scope;
+    size_t k = ctx.limbs();
+    const uint64_t *pn = ctx.n.data();
+    LimbBuffer scratch(ctx.scratch_size()), t(k + 1);
+
+    // Các phép toán mod n trên mảng k block (out có thể trùng a, b)
+    auto add_mod = [&](const uint64_t *a, const uint64_t *b, uint64_t *out)
     {
-        cout << "p khong hop le [!]" << endl;
-        return BigInt(0);
-    }
+        uint64_t carry = 0;
+        for (size_t i = 0; i < k; i++)
+        {
+            uint128_t sum = (uint128_t)a[i] + b[i] + carry;
+            t[i] = (uint64_t)sum;
+            carry = (uint64_t)(sum >> 64);
+        }
+        t[k] = carry;
+        ctx.reduce_final(t.data(), out);
+    };
+    auto sub_mod = [&](const uint64_t *a, const uint64_t *b, uint64_t *out)
+    {
+        uint64_t borrow = 0;
+        for (size_t i = 0; i < k; i++)
+        {
+            uint128_t diff = (uint128_t)a[i] - b[i] - borrow;
+            out[i] = (uint64_t)diff;
+            borrow = (uint64_t)(diff >> 64) & 1;
+        }
+        uint64_t mask = 0 - borrow;
+        uint64_t carry = 0;
+        for (size_t i = 0; i < k; i++)
+        {
+            uint128_t sum = (uint128_t)out[i] + (pn[i] & mask) + carry;
+            out[i] = (uint64_t)sum;
+            carry = (uint64_t)(sum >> 64);
+        }
+    };
+    auto half_mod = [&](uint64_t *a)
+    {
+        uint64_t mask = 0 - (a[0] & 1);
+        uint64_t carry = 0;
+        for (size_t i = 0; i < k; i++)
+        {
+            uint128_t sum = (uint128_t)a[i] + (pn[i] & mask) + carry;
+            a[i] = (uint64_t)sum;
+            carry = (uint64_t)(sum >> 64);
+        }
+        for (size_t i = 0; i < k; i++)
+            a[i] = (a[i] >> 1) | ((i + 1 < k ? a[i + 1] : carry) << 63);
+    };
+    // out = a * c mod n với c là số nguyên có dấu nhỏ (D, Q): nhân đôi và cộng,
+    // vài phép cộng O(k) thay cho 1 phép nhân Montgomery O(k^2) (giữ nguyên dạng Montgomery)
+    LimbBuffer acc(k), zero(k, 0);
+    auto mul_small = [&](const uint64_t *a, int64_t c, uint64_t *out)
+    {
+        uint64_t m = c < 0 ? 0 - (uint64_t)c : (uint64_t)c;
+        fill(acc.begin(), acc.end(), 0);
+        for (int bit = 63 - __builtin_clzll(m | 1); bit >= 0; bit--)
+        {
+            add_mod(acc.data(), acc.data(), acc.data());
+            if ((m >> bit) & 1)
+                add_mod(acc.data(), a, acc.data());
+        }
+        if (c < 0)
+            sub_mod(zero.data(), acc.data(), out);
+        else
+            copy(acc.begin(), acc.end(), out);
+    };
+    auto is_zero = [&](const LimbBuffer &a)
+    {
+        for (size_t i = 0; i < k; i++)
+        {
+            if (a[i])
+                return false;
+        }
+        return true;
+    };
 
-    BigInt key;
-    size_t num_blocks = p.data.size();
+    BigInt d = n + 1;
+    int s = 0;
+    while (!d.bit(s))
+        s++;
+    d >>= s;
 
-    // Tạo đủ số block cho data
-    key.data.resize(num_blocks);
+    int64_t Q = (1 - D) / 4;
+    LimbBuffer U = ctx.one(), V = ctx.one(), Qk(k), tmp(k), du(k);
+    mul_small(ctx.one().data(), Q, Qk.data());
+    // Q = -1 (D = 5, khoảng 1/2 số n): Q^k = ±1 --> (Q^k)^2 = 1, bỏ được 1 phép bình phương mỗi bit
+    auto square_qk = [&]()
+    {
+        if (Q == -1)
+            copy(ctx.one().begin(), ctx.one().end(), Qk.begin());
+        else
+            ctx.sqr(Qk.data(), Qk.data(), scratch.data());
+    };
+    for (size_t i = d.bit_length() - 1; i-- > 0;)
+    {
+        ctx.mul(U.data(), V.data(), U.data(), scratch.data());
+        ctx.sqr(V.data(), V.data(), scratch.data());
+        add_mod(Qk.data(), Qk.data(), tmp.data());
+        sub_mod(V.data(), tmp.data(), V.data());
+        square_qk();
+        if (d.bit(i))
+        {
+            mul_small(U.data(), D, du.data());
+            add_mod(U.data(), V.data(), U.data());
+            half_mod(U.data());
+            add_mod(du.data(), V.data(), V.data());
+            half_mod(V.data());
+            mul_small(Qk.data(), Q, Qk.data());
+        }
+    }
 
-    // Tạo seed
-    srand(static_cast<unsigned>(time(nullptr)));
-    // Tạo random giá trị cho từng block
-    for (size_t i = 0; i < num_blocks; i++)
+    if (is_zero(U) || is_zero(V))
+        return true;
+    for (int r = 1; r < s; r++)
     {
-        key.data[i] = ((uint32_t)rand() << 16) ^ (uint32_t)rand(); // 32-bit random
+        ctx.sqr(V.data(), V.data(), scratch.data());
+        add_mod(Qk.data(), Qk.data(), tmp.data());
+        sub_mod(V.data(), tmp.data(), V.data());
+        if (is_zero(V))
+            return true;
+        if (r + 1 < s)
+            square_qk();
     }
+    return false;
+}
 
-    // Đảm bảo giá trị từ 2, p-2
-    key = (key % BigInt(p - 3)) + BigInt(2);
+// Căn bậc hai nguyên
+/*
+    @logic
+    Newton: x_(i+1) = (x_i + n / x_i) / 2, bắt đầu từ x_0 = 2^ceil(bits / 2) >= sqrt(n),
+    dãy giảm dần cho tới khi không giảm nữa --> x = floor(sqrt(n))
+*/
+BigInt BigInt::isqrt(const BigInt &n)
+{
+    if (n < 2)
+        return n;
+    BigInt x(1);
+    x <<= (int)((n.bit_length() + 1) / 2);
+    while (true)
+    {
+        BigInt y = (x + n / x) >> 1;
+        if (!(y < x))
+            return x;
+        x = y;
+    }
+}
 
-    key.trim();
+bool BigInt::is_probable_prime(const BigInt &n, PrimalityTest test)
+{
+    return test == PrimalityTest::BAILLIE_PSW ? is_prime_by_Baillie_PSW(n) : is_prime_by_Miller_Rabin(n);
+}
 
-    return key;
+// Bảng số nguyên tố lẻ nhỏ (< 2^14, khoảng 1900 số)
+/*
+    @logic
+    Sàng Eratosthenes, chỉ chạy 1 lần (biến static) và dùng lại cho mọi lần sinh số nguyên tố
+*/
+const vector<uint32_t> &BigInt::small_primes()
+{
+    static const vector<uint32_t> primes = []()
+    {
+        const uint32_t limit = 1u << 14;
+        vector<bool> composite(limit, false);
+        vector<uint32_t> result;
+        for (uint32_t i = 3; i < limit; i += 2)
+        {
+            if (composite[i])
+                continue;
+            result.push_back(i);
+            for (uint32_t j = i * i; j < limit; j += 2 * i)
+                composite[j] = true;
+        }
+        return result;
+    }();
+    return primes;
+}
+
+// Số dư khi chia cho số 32 bit, chia từng block từ hàng cao xuống
+uint32_t BigInt::mod_small(uint32_t m) const
+{
+    uint64_t rem = 0;
+    for (int i = (int)data.size() - 1; i >= 0; i--)
+        rem = ((rem << 32) | data[i]) % m;
+    return (uint32_t)rem;
+}
+
+// Chia tại chỗ cho số 32 bit (chia tay từ block cao xuống), trả về số dư
+uint32_t BigInt::div_small(uint32_t d)
+{
+    if (d == 0)
+        throw runtime_error("Division by zero!");
+    uint64_t rem = 0;
+    for (size_t i = data.size(); i-- > 0;)
+    {
+        uint64_t cur = (rem << 32) | data[i];
+        data[i] = (uint32_t)(cur / d);
+        rem = cur % d;
+    }
+    trim();
+    return (uint32_t)rem;
+}
+
+// Sinh ứng viên bằng sàng số nguyên tố nhỏ
+/*
+    @param bits (Số bit của số nguyên tố cần tìm, với safe = true là số bit của q)
+    @param safe (true: tìm q sao cho q và 2q + 1 đều là số nguyên tố, trả về 2q + 1)
+    @logic
+    1. Chọn điểm bắt đầu ngẫu nhiên start (lẻ, đủ bits bit)
+    2. Bảng dư residues[i] = start mod primes[i], chỉ tính 1 lần
+    3. Duyệt ứng viên start + delta (delta chẵn), mỗi bước cộng 2 vào mọi số dư:
+        - Loại nếu q chia hết cho primes[i] (residue = 0)
+        - Với safe: loại thêm nếu 2q + 1 chia hết cho primes[i] (residue = (primes[i] - 1) / 2)
+    4. Chỉ ứng viên qua được sàng mới chạy kiểm tra số nguyên tố (test)
+    5. Ứng viên vượt quá bits bit: chọn điểm bắt đầu mới
+    6. stop được kiểm tra trước mỗi lần chạy Miller-Rabin (thread khác đã tìm thấy kết quả)
+    7. Số tạm của mỗi ứng viên nằm trong 1 LimbArena::Scope riêng --> bộ nhớ không tăng theo số ứng viên
+*/
+BigInt BigInt::sieve_search(int bits, bool safe, PrimalityTest test, const atomic<bool> *stop)
+{
+    LimbArena::Scope scope;
+    const uint64_t SIEVE_SPAN = 1ULL << 26;
+    const vector<uint32_t> &primes = small_primes();
+    vector<uint32_t> residues(primes.size());
+    while (true)
+    {
+        BigInt start = random_bits(bits);
+        for (size_t i = 0; i < primes.size(); i++)
+            residues[i] = start.mod_small(primes[i]);
+
+        for (uint64_t delta = 0; delta < SIEVE_SPAN; delta += 2)
+        {
+            if (delta)
+            {
+                for (size_t i = 0; i < primes.size(); i++)
+                {
+                    residues[i] += 2;
+                    if (residues[i] >= primes[i])
+                        residues[i] -= primes[i];
+                }
+            }
+
+            DH_COUNT(CANDIDATES, 1);
+            bool pass = true;
+            for (size_t i = 0; i < primes.size(); i++)
+            {
+                if (residues[i] == 0 || (safe && residues[i] == (primes[i] - 1) / 2))
+                {
+                    pass = false;
+                    break;
+                }
+            }
+            if (!pass)
+            {
+                DH_COUNT(SIEVE_REJECTS, 1);
+                continue;
+            }
+            if (stop && stop->load(memory_order_relaxed))
+                return BigInt(0);
+
+            LimbArena::Scope attempt;
+            BigInt candidate = start + delta;
+            if ((int)candidate.bit_length() != bits)
+                break;
+            if (!is_probable_prime(candidate, test))
+                continue;
+            if (!safe)
+                return LimbArena::detach(candidate);
+            if (stop && stop->load(memory_order_relaxed))
+                return BigInt(0);
+            BigInt p = candidate;
+            p.mul_add_small(2, 1);
+            if (is_probable_prime(p, test))
+                return LimbArena::detach(p);
+        }
+    }
+}
+
+// Hàm tạo số nguyên tố
+/*
+    @logic
+    1. Số lớn: sinh ứng viên bằng sàng số nguyên tố nhỏ (sieve_search)
+    2. Số nhỏ (ứng viên có thể trùng số trong bảng sàng): thử trực tiếp từ hàm random_bits
+    3. Kiểm tra lại xem tính chính xác của số nguyên tố p
+*/
+BigInt BigInt::generate_prime(int bits, PrimalityTest test)
+{
+    DH_TIME(GENERATE_PRIME);
+    if (bits > 16)
+        return sieve_search(bits, false, test);
+    LimbArena::Scope scope;
+    while (true)
+    {
+        BigInt p = random_bits(bits);
+        if (is_probable_prime(p, test))
+            return LimbArena::detach(p);
+    }
+}
+
+// Hàm tạo số nguyên tố an toàn
+/*
+    @logic
+    1. Sinh một số nguyên tố q (bits-1 bit) bằng Miller-Rabin
+    2. Tạo p = 2*q + 1
+    3. Kiểm tra p có phải là số nguyên tố bằng Miller-Rabin
+    4. Nếu đúng, p là safe prime (vì (p-1)/2 = q cũng là prime)
+    5. Số lớn: sàng đồng thời q và 2q + 1, Miller-Rabin chỉ chạy trên ứng viên qua cả 2 sàng
+*/
+BigInt BigInt::generate_safe_prime(int bits, PrimalityTest test)
+{
+    DH_TIME(GENERATE_SAFE_PRIME);
+    int q_bits = bits - 1;
+    if (q_bits > 16)
+        return sieve_search(q_bits, true, test);
+    LimbArena::Scope scope;
+    while (true)
+    {
+        BigInt q = BigInt::generate_prime(q_bits, test);
+        BigInt p = q * 2 + 1;
+        if (BigInt::is_probable_prime(p, test))
+        {
+            return LimbArena::detach(p);
+        }
+    }
+};
+
+// Hàm tạo số nguyên tố an toàn song song
+/*
+    @param bits (Số bit của p)
+    @param threads (Số thread, 0 = hardware_concurrency)
+    @logic
+    1. Mỗi thread chạy sieve_search với điểm bắt đầu ngẫu nhiên riêng
+    (random_bits dùng generator riêng cho mỗi thread --> các dãy ứng viên độc lập)
+    2. Thread đầu tiên tìm được p = 2q + 1 bật cờ found (compare_exchange) và ghi kết quả
+    3. Các thread còn lại thấy cờ found ở lần kiểm tra tiếp theo và dừng
+*/
+BigInt BigInt::generate_safe_prime_parallel(int bits, unsigned threads, PrimalityTest test)
+{
+    DH_TIME(GENERATE_SAFE_PRIME_PARALLEL);
+    if (threads == 0)
+        threads = max(1u, thread::hardware_concurrency());
+    if (threads == 1 || bits - 1 <= 16)
+        return generate_safe_prime(bits, test);
+
+    atomic<bool> found(false);
+    BigInt result;
+    vector<thread> workers;
+    workers.reserve(threads);
+    for (unsigned t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&]()
+                             {
+            BigInt p = sieve_search(bits - 1, true, test, &found);
+            bool expected = false;
+            if (!p.data.empty() && found.compare_exchange_strong(expected, true))
+                result = p; });
+    }
+    for (thread &worker : workers)
+        worker.join();
+    return result;
+}
+
+// Hàm sinh khóa riêng trong khoảng [2, p−2]
+BigInt BigInt::generate_private_key(const BigInt &p)
+{
+    DH_TIME(PRIVATE_KEY);
+    if (p < 5)
+    {
+        cout << "p khong hop le [!]" << endl;
+        return BigInt(0);
+    }
+
+    BigInt key;
+    size_t num_blocks = p.data.size();
+
+    // Tạo đủ số block cho data
+    key.data.resize(num_blocks);
+
+    // Tạo random giá trị cho từng block (bộ sinh riêng của thread, không seed lại theo giây
+    // --> các khóa sinh trong cùng 1 giây / trên nhiều thread không trùng nhau)
+    mt19937_64 &gen = rng();
+    for (size_t i = 0; i < num_blocks; i++)
+    {
+        key.data[i] = (uint32_t)gen(); // 32-bit random
+    }
+
+    // Đảm bảo giá trị từ 2, p-2
+    key %= p - 3;
+    key += 2;
+
+    key.trim();
+
+    return key;
+}
+
+// Ký hiệu Jacobi nhị phân (chỉ dịch bit và trừ, không có phép chia)
+/*
+    @param a, n (k block 64 bit, n lẻ, a < n), bị ghi đè trong lúc tính
+    @return (a / n) thuộc {-1, 0, 1}
+    @logic
+    1. a = 2^t * a': (2 / n) = -1 khi n mod 8 = 3 hoặc 5 --> đổi dấu nếu t lẻ
+    2. a, n đều lẻ: a < n thì đổi chỗ theo luật thuận nghịch bậc hai
+        (a / n) = -(n / a) khi a mod 4 = n mod 4 = 3, ngược lại bằng nhau
+    3. a = a - n (a >= n, hiệu chẵn), (a / n) không đổi vì a = a - n mod n
+    4. a = 0: kết quả là dấu hiện tại nếu n = 1, ngược lại gcd > 1 --> 0
+    Mỗi vòng giảm a ít nhất 1 bit --> O(số bit) vòng, mỗi vòng O(len) block
+    len: số block còn dùng của max(a, n), giảm dần khi các block cao về 0
+*/
+int BigInt::jacobi_limbs64(uint64_t *a, uint64_t *n, size_t k)
+{
+    int sign = 1;
+    size_t len = k;
+    while (true)
+    {
+        while (len > 1 && a[len - 1] == 0 && n[len - 1] == 0)
+            len--;
+
+        size_t z = 0;
+        while (z < len && a[z] == 0)
+            z++;
+        if (z == len)
+        {
+            bool one = n[0] == 1;
+            for (size_t i = 1; i < len && one; i++)
+                one = n[i] == 0;
+            return one ? sign : 0;
+        }
+
+        // Bỏ thừa số 2 của a
+        size_t shift = z * 64 + __builtin_ctzll(a[z]);
+        if (shift)
+        {
+            size_t words = shift / 64, bits = shift % 64;
+            for (size_t i = 0; i < len; i++)
+            {
+                uint64_t lo = i + words < len ? a[i + words] : 0;
+                uint64_t hi = i + words + 1 < len ? a[i + words + 1] : 0;
+                a[i] = bits ? (lo >> bits) | (hi << (64 - bits)) : lo;
+            }
+            uint64_t n8 = n[0] & 7;
+            if ((shift & 1) && (n8 == 3 || n8 == 5))
+                sign = -sign;
+        }
+
+        // a < n: đổi chỗ (luật thuận nghịch bậc hai)
+        bool less = false;
+        for (size_t i = len; i-- > 0;)
+        {
+            if (a[i] != n[i])
+            {
+                less = a[i] < n[i];
+                break;
+            }
+        }
+        if (less)
+        {
+            swap(a, n);
+            if ((a[0] & 3) == 3 && (n[0] & 3) == 3)
+                sign = -sign;
+        }
+
+        // a = a - n
+        uint64_t borrow = 0;
+        for (size_t i = 0; i < len; i++)
+        {
+            uint128_t diff = (uint128_t)a[i] - n[i] - borrow;
+            a[i] = (uint64_t)diff;
+            borrow = (uint64_t)(diff >> 64) & 1;
+        }
+    }
+}
+
+int BigInt::jacobi(const BigInt &a, const BigInt &n)
+{
+    if (!n.is_odd())
+        throw runtime_error("Jacobi symbol requires an odd positive modulus!");
+    LimbArena::Scope scope;
+    size_t k = (n.data.size() + 1) / 2;
+    LimbBuffer x(k), y(k);
+    to_limbs64(a < n ? a : a % n, x.data(), k);
+    to_limbs64(n, y.data(), k);
+    return jacobi_limbs64(x.data(), y.data(), k);
+}
+
+// Kiểm tra khóa công khai của bên kia
+/*
+    @param y (Khóa công khai nhận được)
+    @param p (Số nguyên tố an toàn p = 2q + 1, như generate_safe_prime / nhóm RFC)
+    @logic
+    1. Loại y <= 1 và y >= p - 1 (các phần tử cấp 1, 2 làm lộ bit của khóa riêng)
+    2. Nhóm nhân mod p có cấp 2q --> nhóm con cấp q đúng bằng tập thặng dư bậc hai
+    --> y thuộc nhóm con <=> ký hiệu Legendre (y / p) = 1 (tiêu chuẩn Euler: y^q = (y / p) mod p)
+    3. Tính (y / p) bằng Jacobi nhị phân: O(n^2) phép toán block thay vì O(n^3) của y^q mod p
+    Yêu cầu phần tử sinh g cũng là thặng dư bậc hai (g = 2 của nhóm RFC, g = 4 của PrimeStore)
+*/
+bool BigInt::validate_public_key(const BigInt &y, const BigInt &p)
+{
+    return validate_public_key_batch(vector<BigInt>{y}, p)[0];
+}
+
+vector<bool> BigInt::validate_public_key_batch(const vector<BigInt> &ys, const BigInt &p)
+{
+    if (!p.is_odd() || p < 5)
+        throw runtime_error("Public key validation requires an odd prime p > 3!");
+    vector<bool> result(ys.size());
+    LimbArena::Scope scope;
+    size_t k = (p.data.size() + 1) / 2;
+    BigInt p_minus_1 = p - 1;
+    LimbBuffer p_limbs(k), a(k), n(k);
+    to_limbs64(p, p_limbs.data(), k);
+    for (size_t i = 0; i < ys.size(); i++)
+    {
+        const BigInt &y = ys[i];
+        if (!(y > 1) || !(y < p_minus_1))
+            continue;
+        to_limbs64(y, a.data(), k);
+        copy(p_limbs.begin(), p_limbs.end(), n.begin());
+        result[i] = jacobi_limbs64(a.data(), n.data(), k) == 1;
+    }
+    return result;
+}
+
+// Ngữ cảnh Montgomery
+/*
+    @param mod (Modulus lẻ p)
+    @logic
+    1. k = số block 64 bit của p, R = 2^(64k) --> gcd(R, p) = 1 vì p lẻ
+    2. n0_inv = -p^-1 mod 2^64, tính bằng phép lặp Newton:
+        inv = inv * (2 - p0 * inv), mỗi lần lặp nhân đôi số bit đúng (1 -> 2 -> 4 -> ... -> 64)
+    3. R mod p và R^2 mod p chỉ tính 1 lần ở đây (2 phép mod), dùng lại cho mọi phép nhân sau
+*/
+MontgomeryContext::MontgomeryContext(const BigInt &modulus) : mod(modulus)
+{
+    if (mod.data.empty() || (mod.data[0] & 1) == 0)
+        throw runtime_error("Montgomery modulus must be odd!");
+    k = (mod.data.size() + 1) / 2;
+    n.assign(k, 0);
+    BigInt::to_limbs64(mod, n.data(), k);
+
+    // Newton: p0 * inv ≡ 1 (mod 2^64)
+    uint64_t p0 = n[0];
+    uint64_t inv = 1;
+    for (int i = 0; i < 6; i++)
+        inv *= 2 - p0 * inv;
+    n0_inv = 0 - inv;
+
+    // R = 2^(64k) = B^(2k)
+    BigInt r;
+    r.data.assign(2 * k + 1, 0);
+    r.data[2 * k] = 1;
+    BigInt r1 = r % mod;
+    BigInt r2 = BigInt::square(r1) % mod;
+
+    r_mod.assign(k, 0);
+    r2_mod.assign(k, 0);
+    BigInt::to_limbs64(r1, r_mod.data(), k);
+    BigInt::to_limbs64(r2, r2_mod.data(), k);
+}
+
+MontgomeryContext::MontgomeryContext(const uint64_t *modulus, size_t limbs, uint64_t inv, const uint64_t *r1, const uint64_t *r2)
+    : mod(BigInt::from_limbs64(modulus, limbs)), k(limbs), n0_inv(inv),
+      n(modulus, modulus + limbs), r_mod(r1, r1 + limbs), r2_mod(r2, r2 + limbs)
+{
+    if ((modulus[0] & 1) == 0)
+        throw runtime_error("Montgomery modulus must be odd!");
+}
+
+// Kernel CIOS (Coarsely Integrated Operand Scanning) trên block 64 bit
+/*
+    @param a, b (k block, < p)
+    @param out (k block, có thể trùng a hoặc b)
+    @param t (vùng nhớ tạm, ít nhất k + 2 block)
+    @logic
+    Với mỗi block b[i]:
+    1. t = t + a * b[i]
+    2. Chọn m = t[0] * n0_inv mod 2^64 để t + m * p chia hết cho 2^64
+    3. t = (t + m * p) / 2^64 (dịch 1 block, gộp chung vào vòng lặp cộng)
+    Sau k vòng: t = a * b * R^-1 mod p, với t < 2p --> trừ p tối đa 1 lần
+    Tích 64 x 64 bit lưu trong uint128_t: a[j] * b[i] + t[j] + carry < 2^128 nên không tràn
+*/
+void MontgomeryContext::mul(const uint64_t *a, const uint64_t *b, uint64_t *out, uint64_t *t) const
+{
+    DH_COUNT(MONT_MUL_CALLS, 1);
+    DH_COUNT(LIMBS_PROCESSED, k);
+    const uint64_t *p = n.data();
+    fill(t, t + k + 2, 0);
+    for (size_t i = 0; i < k; i++)
+    {
+        // t = t + a * b[i]
+        uint64_t bi = b[i];
+        uint64_t carry = 0;
+        for (size_t j = 0; j < k; j++)
+        {
+            uint128_t cur = (uint128_t)a[j] * bi + t[j] + carry;
+            t[j] = (uint64_t)cur;
+            carry = (uint64_t)(cur >> 64);
+        }
+        uint128_t cur = (uint128_t)t[k] + carry;
+        t[k] = (uint64_t)cur;
+        t[k + 1] = (uint64_t)(cur >> 64);
+
+        // t = (t + m * p) / 2^64
+        uint64_t m = t[0] * n0_inv;
+        cur = (uint128_t)m * p[0] + t[0];
+        carry = (uint64_t)(cur >> 64);
+        for (size_t j = 1; j < k; j++)
+        {
+            cur = (uint128_t)m * p[j] + t[j] + carry;
+            t[j - 1] = (uint64_t)cur;
+            carry = (uint64_t)(cur >> 64);
+        }
+        cur = (uint128_t)t[k] + carry;
+        t[k - 1] = (uint64_t)cur;
+        t[k] = t[k + 1] + (uint64_t)(cur >> 64);
+    }
+
+    reduce_final(t, out);
+}
+
+// Bước cuối của phép nhân Montgomery
+/*
+    @param t (k + 1 block, t < 2p)
+    @param out (k block, kết quả t mod p)
+    @logic
+    Nếu t >= p thì trừ p (t[k] != 0 nghĩa là t >= R > p)
+    Luôn tính t - p rồi chọn bằng mặt nạ, không rẽ nhánh theo giá trị t
+    --> mul / sqr chạy cùng 1 chuỗi lệnh với mọi đầu vào (cần cho pow_consttime)
+*/
+void MontgomeryContext::reduce_final(const uint64_t *t, uint64_t *out) const
+{
+    const uint64_t *p = n.data();
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < k; i++)
+    {
+        uint128_t diff = (uint128_t)t[i] - p[i] - borrow;
+        out[i] = (uint64_t)diff;
+        borrow = (uint64_t)(diff >> 64) & 1;
+    }
+    // t[k] - borrow < 0 <=> t < p: keep = toàn bit 1 thì giữ t, ngược lại giữ t - p
+    uint64_t keep = (uint64_t)(((uint128_t)t[k] - borrow) >> 64);
+    for (size_t i = 0; i < k; i++)
+        out[i] = (t[i] & keep) | (out[i] & ~keep);
+}
+
+// Bình phương Montgomery: out = a^2 * R^-1 mod p
+/*
+    @param a (k block, < p)
+    @param out (k block, có thể trùng a)
+    @param t (vùng nhớ tạm 2k + 2 block)
+    @logic
+    1. t = a^2 (2k block) bằng square_limbs64: mỗi tích chéo chỉ tính 1 lần
+    2. Khử Montgomery từng block (tách rời khỏi bước nhân):
+        với i = 0..k-1: m = t[i] * n0_inv, t = t + m * p * 2^(64i) --> t[i] = 0
+    Carry của hàng i được giữ lại (top) và cộng vào t[i + k + 1] ở hàng sau
+    --> độ dài vòng lặp không phụ thuộc giá trị (không lan truyền carry đến khi hết)
+    3. t / R = t[k..2k] < 2p --> reduce_final
+*/
+void MontgomeryContext::sqr(const uint64_t *a, uint64_t *out, uint64_t *t) const
+{
+    DH_COUNT(MONT_SQR_CALLS, 1);
+    DH_COUNT(LIMBS_PROCESSED, k);
+    const uint64_t *p = n.data();
+    BigInt::square_limbs64(a, k, t);
+    t[2 * k] = 0;
+    uint64_t top = 0;
+    for (size_t i = 0; i < k; i++)
+    {
+        uint64_t m = t[i] * n0_inv;
+        uint64_t carry = 0;
+        for (size_t j = 0; j < k; j++)
+        {
+            uint128_t cur = (uint128_t)m * p[j] + t[i + j] + carry;
+            t[i + j] = (uint64_t)cur;
+            carry = (uint64_t)(cur >> 64);
+        }
+        uint128_t cur = (uint128_t)t[i + k] + carry + top;
+        t[i + k] = (uint64_t)cur;
+        top = (uint64_t)(cur >> 64);
+    }
+    t[2 * k] += top;
+    reduce_final(t + k, out);
+}
+
+// Chuyển a sang dạng Montgomery: a * R mod p = mul(a, R^2)
+LimbBuffer MontgomeryContext::to_mont(const BigInt &a) const
+{
+    BigInt reduced = a < mod ? a : a % mod;
+    LimbBuffer x(k, 0), scratch(scratch_size());
+    BigInt::to_limbs64(reduced, x.data(), k);
+    mul(x.data(), r2_mod.data(), x.data(), scratch.data());
+    return x;
+}
+
+// Chuyển về dạng thường: a * R^-1 mod p = mul(a, 1)
+BigInt MontgomeryContext::from_mont(const LimbBuffer &a) const
+{
+    LimbBuffer one_plain(k, 0), x(k), scratch(scratch_size());
+    one_plain[0] = 1;
+    mul(a.data(), one_plain.data(), x.data(), scratch.data());
+    return BigInt::from_limbs64(x.data(), k);
+}
+
+// Lũy thừa trong dạng Montgomery (cửa sổ trượt)
+/*
+    @logic
+    1. Dựng bảng lũy thừa lẻ: table[i] = base^(2i+1), i < 2^(w-1)
+    2. Duyệt bit từ cao xuống thấp:
+        - Bit 0: bình phương result
+        - Bit 1: lấy cửa sổ dài tối đa w bit kết thúc bằng bit 1 (giá trị lẻ v),
+        bình phương result theo độ dài cửa sổ rồi nhân với table[v >> 1]
+    3. Lần nhân đầu tiên chỉ gán result = table[v >> 1] (bỏ các phép bình phương số 1)
+*/
+LimbBuffer MontgomeryContext::pow(const LimbBuffer &base_m, const BigInt &exp) const
+{
+    size_t nbits = exp.bit_length();
+    if (nbits == 0)
+        return r_mod;
+
+    int w = BigInt::window_width(nbits);
+    size_t table_size = (size_t)1 << (w - 1);
+    LimbBuffer scratch(scratch_size());
+    // Bảng lưu liên tiếp trong 1 vector, mỗi phần tử k block
+    LimbBuffer table(table_size * k);
+    copy(base_m.begin(), base_m.end(), table.begin());
+    LimbBuffer base_sq(k);
+    sqr(base_m.data(), base_sq.data(), scratch.data());
+    for (size_t i = 1; i < table_size; i++)
+        mul(&table[(i - 1) * k], base_sq.data(), &table[i * k], scratch.data());
+
+    LimbBuffer result(k);
+    bool started = false;
+    int i = (int)nbits - 1;
+    while (i >= 0)
+    {
+        if (!exp.bit(i))
+        {
+            sqr(result.data(), result.data(), scratch.data());
+            i--;
+            continue;
+        }
+        int l = max(i - w + 1, 0);
+        while (!exp.bit(l))
+            l++;
+        uint32_t value = 0;
+        for (int j = i; j >= l; j--)
+            value = (value << 1) | (uint32_t)exp.bit(j);
+
+        const uint64_t *entry = &table[(value >> 1) * k];
+        if (started)
+        {
+            for (int j = i; j >= l; j--)
+                sqr(result.data(), result.data(), scratch.data());
+            mul(result.data(), entry, result.data(), scratch.data());
+        }
+        else
+        {
+            copy(entry, entry + k, result.begin());
+            started = true;
+        }
+        i = l - 1;
+    }
+    return result;
+}
+
+// Lũy thừa trong dạng Montgomery, thời gian hằng theo exp
+/*
+    @logic
+    1. exp chép vào e gồm max(k, số block 64 bit của exp) block --> số bit duyệt chỉ phụ thuộc
+    kích thước modulus (khóa riêng < p), không phụ thuộc bit_length() của exp
+    2. Bảng đầy đủ table[v] = base^v, v < 2^w, w cố định theo số block (4 / 5 / 6)
+    3. Mỗi cửa sổ: bình phương w lần, chọn table[v] bằng cách đọc hết mọi phần tử và giữ lại
+    phần tử có chỉ số v bằng mặt nạ (không đánh chỉ số theo v --> địa chỉ bộ nhớ không lộ v),
+    rồi nhân (kể cả v = 0)
+    4. mul / sqr / reduce_final không rẽ nhánh theo dữ liệu
+*/
+LimbBuffer MontgomeryContext::pow_consttime(const LimbBuffer &base_m, const BigInt &exp) const
+{
+    size_t e_limbs = max(k, (exp.data.size() + 1) / 2);
+    // w chỉ theo kích thước (công khai): bảng 2^w phần tử, quét toàn bộ mỗi cửa sổ
+    const int w = e_limbs > 32 ? 6 : (e_limbs > 8 ? 5 : 4);
+    const size_t table_size = (size_t)1 << w;
+    LimbBuffer e(e_limbs);
+    BigInt::to_limbs64(exp, e.data(), e_limbs);
+
+    LimbBuffer scratch(scratch_size());
+    LimbBuffer table(table_size * k);
+    copy(r_mod.begin(), r_mod.end(), table.begin());
+    copy(base_m.begin(), base_m.end(), table.begin() + k);
+    for (size_t i = 2; i < table_size; i++)
+    {
+        // Lũy thừa chẵn bằng bình phương (rẻ hơn phép nhân)
+        if (i % 2 == 0)
+            sqr(&table[(i / 2) * k], &table[i * k], scratch.data());
+        else
+            mul(&table[(i - 1) * k], base_m.data(), &table[i * k], scratch.data());
+    }
+
+    size_t nbits = e_limbs * 64;
+    size_t windows = (nbits + w - 1) / w;
+    LimbBuffer result = r_mod, selected(k);
+    for (size_t win = windows; win-- > 0;)
+    {
+        uint64_t value = 0;
+        for (int j = w - 1; j >= 0; j--)
+        {
+            size_t b = win * w + j;
+            uint64_t bit = b < nbits ? (e[b / 64] >> (b % 64)) & 1 : 0;
+            value = (value << 1) | bit;
+        }
+        for (int j = 0; j < w && win != windows - 1; j++)
+            sqr(result.data(), result.data(), scratch.data());
+
+        // selected = table[value]: mask = toàn bit 1 khi v == value (d = 0), ngược lại 0
+        fill(selected.begin(), selected.end(), 0);
+        for (size_t v = 0; v < table_size; v++)
+        {
+            uint64_t d = v ^ value;
+            uint64_t mask = ((d | (0 - d)) >> 63) - 1;
+            const uint64_t *entry = &table[v * k];
+            for (size_t i = 0; i < k; i++)
+                selected[i] |= entry[i] & mask;
+        }
+        mul(result.data(), selected.data(), result.data(), scratch.data());
+    }
+    return result;
+}
+
+// Bảng lũy thừa cho cơ số cố định
+/*
+    @param g (Cơ số cố định)
+    @param p (Modulus lẻ)
+    @param window (Độ rộng cửa sổ w)
+    @param exp_bits (Độ dài số mũ tối đa)
+    @logic
+    1. cur = g^(2^(w*i)) cho cửa sổ thứ i (bắt đầu từ g)
+    2. Phần tử (i, v) = cur^v, dựng bằng cách nhân dồn v = 1 -> 2^w - 1
+    3. Cửa sổ tiếp theo: cur^(2^w) = (i, 2^w - 1) * cur
+*/
+FixedBaseTable::FixedBaseTable(const BigInt &g, const BigInt &p, int window, size_t exp_bits)
+    : FixedBaseTable(g, MontgomeryContext(p), window, exp_bits)
+{
+}
+
+FixedBaseTable::FixedBaseTable(const BigInt &g, const MontgomeryContext &context, int window, size_t exp_bits)
+    : ctx(context), base(g), w(window)
+{
+    if (w < 1 || w > 16)
+        throw runtime_error("FixedBaseTable window must be in [1, 16]!");
+    if (exp_bits == 0)
+        exp_bits = ctx.modulus().bit_length();
+    // Phủ trọn số block 64 bit: pow_consttime chỉ cần so số block của exp (công khai) với bảng
+    windows = ((exp_bits + 63) / 64 * 64 + w - 1) / w;
+
+    size_t k = ctx.limbs();
+    size_t per_window = ((size_t)1 << w) - 1;
+    table.resize(windows * per_window * k);
+    LimbBuffer scratch(ctx.scratch_size());
+    LimbBuffer cur = ctx.to_mont(g);
+    for (size_t i = 0; i < windows; i++)
+    {
+        uint64_t *row = &table[i * per_window * k];
+        copy(cur.begin(), cur.end(), row);
+        for (size_t v = 1; v < per_window; v++)
+            ctx.mul(row + (v - 1) * k, cur.data(), row + v * k, scratch.data());
+        if (i + 1 < windows)
+            ctx.mul(row + (per_window - 1) * k, cur.data(), cur.data(), scratch.data());
+    }
+}
+
+// Lũy thừa với cơ số cố định
+/*
+    @logic
+    1. Chia exp thành các cửa sổ w bit: exp = sum(v_i * 2^(w*i))
+    2. g^exp = tích các phần tử (i, v_i) với v_i != 0
+    3. Số mũ dài hơn bảng: quay về lũy thừa cửa sổ trượt thông thường
+*/
+BigInt FixedBaseTable::pow(const BigInt &exp) const
+{
+    DH_TIME(FIXED_BASE_POW);
+    if (exp.bit_length() > windows * w)
+        return BigInt::modular_exponentiation(base, exp, ctx);
+
+    LimbArena::Scope scope;
+    size_t k = ctx.limbs();
+    size_t per_window = ((size_t)1 << w) - 1;
+    LimbBuffer result = ctx.one();
+    LimbBuffer scratch(ctx.scratch_size());
+    bool started = false;
+    for (size_t i = 0; i < windows; i++)
+    {
+        uint32_t value = 0;
+        for (int j = w - 1; j >= 0; j--)
+            value = (value << 1) | (uint32_t)exp.bit(i * w + j);
+        if (value == 0)
+            continue;
+        const uint64_t *entry = &table[(i * per_window + value - 1) * k];
+        if (started)
+            ctx.mul(result.data(), entry, result.data(), scratch.data());
+        else
+        {
+            copy(entry, entry + k, result.begin());
+            started = true;
+        }
+    }
+    return LimbArena::detach(ctx.from_mont(result));
+}
+
+// Lũy thừa với cơ số cố định, thời gian hằng theo exp (số mũ bí mật, ví dụ khóa riêng)
+/*
+    @logic
+    1. exp chép vào e gồm đủ số block mà bảng phủ; exp nhiều block hơn (chỉ phụ thuộc kích thước)
+    thì dùng modular_exponentiation_consttime
+    2. Duyệt đủ mọi cửa sổ, kể cả cửa sổ có giá trị 0
+    3. Mỗi cửa sổ đọc toàn bộ 2^w phần tử (ctx.one() cho v = 0, hàng i của bảng cho v >= 1)
+    và giữ lại phần tử có chỉ số v bằng mặt nạ, rồi luôn nhân vào result
+    --> số phép nhân và địa chỉ truy cập bộ nhớ không phụ thuộc giá trị exp
+*/
+BigInt FixedBaseTable::pow_consttime(const BigInt &exp) const
+{
+    DH_TIME(FIXED_BASE_POW_CONSTTIME);
+    // Số block trọn vẹn mà bảng phủ (windows * w >= 64 * e_limbs, xem constructor)
+    size_t e_limbs = windows * w / 64;
+    if ((exp.data.size() + 1) / 2 > e_limbs)
+        return BigInt::modular_exponentiation_consttime(base, exp, ctx);
+
+    LimbArena::Scope scope;
+    size_t k = ctx.limbs();
+    size_t per_window = ((size_t)1 << w) - 1;
+    LimbBuffer e(e_limbs);
+    BigInt::to_limbs64(exp, e.data(), e_limbs);
+    const uint64_t *one = ctx.one().data();
+    LimbBuffer result = ctx.one(), selected(k);
+    LimbBuffer scratch(ctx.scratch_size());
+    for (size_t i = 0; i < windows; i++)
+    {
+        uint64_t value = 0;
+        for (int j = w - 1; j >= 0; j--)
+        {
+            size_t b = i * w + j;
+            uint64_t bit = b < e_limbs * 64 ? (e[b / 64] >> (b % 64)) & 1 : 0;
+            value = (value << 1) | bit;
+        }
+        // mask = toàn bit 1 khi v == value, ngược lại 0
+        uint64_t mask = ((value | (0 - value)) >> 63) - 1;
+        for (size_t j = 0; j < k; j++)
+            selected[j] = one[j] & mask;
+        const uint64_t *row = &table[i * per_window * k];
+        for (size_t v = 1; v <= per_window; v++)
+        {
+            uint64_t d = v ^ value;
+            mask = ((d | (0 - d)) >> 63) - 1;
+            const uint64_t *entry = row + (v - 1) * k;
+            for (size_t j = 0; j < k; j++)
+                selected[j] |= entry[j] & mask;
+        }
+        ctx.mul(result.data(), selected.data(), result.data(), scratch.data());
+    }
+    return LimbArena::detach(ctx.from_mont(result));
+}
+
+// Lũy thừa mod hàng loạt (cơ số 2^52, xen kẽ theo làn)
+/*
+    @param p (Modulus lẻ)
+    @logic
+    1. k = số block 52 bit của p, R = 2^(52k) > p
+    2. n0_inv = -p^-1 mod 2^52 (lấy 52 bit thấp của -p^-1 mod 2^64 từ phép lặp Newton)
+    3. R^2 mod p tính 1 lần bằng BigInt, rồi tách thành block 52 bit cho mọi làn
+*/
+BatchModExp::BatchModExp(const BigInt &p) : mod(p), ctx(p)
+{
+    const uint64_t MASK52 = (1ULL << 52) - 1;
+    k = (p.bit_length() + 51) / 52;
+
+    // Tách BigInt thành k block 52 bit, lặp lại ở mọi làn
+    auto split52 = [this, MASK52](const BigInt &x, LimbBuffer &out)
+    {
+        size_t k64 = (x.data.size() + 1) / 2 + 1;
+        LimbBuffer w(k64);
+        BigInt::to_limbs64(x, w.data(), k64);
+        out.assign(k * LANES, 0);
+        for (size_t j = 0; j < k; j++)
+        {
+            size_t bit = 52 * j;
+            size_t idx = bit / 64, off = bit % 64;
+            uint64_t digit = idx < k64 ? w[idx] >> off : 0;
+            if (off > 12 && idx + 1 < k64)
+                digit |= w[idx + 1] << (64 - off);
+            for (size_t lane = 0; lane < LANES; lane++)
+                out[j * LANES + lane] = digit & MASK52;
+        }
+    };
+    split52(p, n);
+
+    uint64_t p0 = (uint64_t)p.data[0] | ((uint64_t)(p.data.size() > 1 ? p.data[1] : 0) << 32);
+    uint64_t inv = 1;
+    for (int i = 0; i < 6; i++)
+        inv *= 2 - p0 * inv;
+    n0_inv = (0 - inv) & MASK52;
+
+    // R^2 = 2^(104k)
+    size_t bit = 104 * k;
+    BigInt r;
+    r.data.assign(bit / 32 + 1, 0);
+    r.data[bit / 32] = 1u << (bit % 32);
+    split52(r % p, r2);
+}
+
+#if defined(__AVX512IFMA__)
+// Kernel Montgomery trên LANES làn (cơ số 2^52)
+/*
+    @logic
+    Với mỗi block b[i] (mọi làn cùng lúc):
+    1. t = t + a * b[i]: tích 104 bit tách thành 52 bit thấp (cộng vào t[j]) và 52 bit cao (cộng vào t[j+1])
+    2. m = t[0] * n0_inv mod 2^52, t = t + m * p --> t[0] chia hết cho 2^52
+    3. Đẩy t[0] >> 52 lên t[1], dịch t xuống 1 block
+    Các block t[j] được cộng dồn không chuẩn hóa (< 4k * 2^52 < 2^64 với k < 1024),
+    chỉ chuẩn hóa carry 1 lần ở cuối, sau đó trừ p nếu t >= p (chọn theo từng làn, không rẽ nhánh).
+*/
+void BatchModExp::mul(const uint64_t *a, const uint64_t *b, uint64_t *out, uint64_t *t) const
+{
+    const size_t W = LANES;
+    const uint64_t MASK52 = (1ULL << 52) - 1;
+    fill(t, t + (k + 1) * W, 0);
+    for (size_t i = 0; i < k; i++)
+    {
+        const uint64_t *bi = b + i * W;
+        uint64_t m[W];
+        __m512i vb = _mm512_loadu_si512(bi);
+        __m512i cur = _mm512_loadu_si512(t);
+        for (size_t j = 0; j < k; j++)
+        {
+            __m512i va = _mm512_loadu_si512(a + j * W);
+            __m512i next = _mm512_loadu_si512(t + (j + 1) * W);
+            cur = _mm512_madd52lo_epu64(cur, va, vb);
+            next = _mm512_madd52hi_epu64(next, va, vb);
+            _mm512_storeu_si512(t + j * W, cur);
+            cur = next;
+        }
+        _mm512_storeu_si512(t + k * W, cur);
+
+        for (size_t lane = 0; lane < W; lane++)
+            m[lane] = (t[lane] * n0_inv) & MASK52;
+        __m512i vm = _mm512_loadu_si512(m);
+        cur = _mm512_loadu_si512(t);
+        for (size_t j = 0; j < k; j++)
+        {
+            __m512i vn = _mm512_loadu_si512(&n[j * W]);
+            __m512i next = _mm512_loadu_si512(t + (j + 1) * W);
+            cur = _mm512_madd52lo_epu64(cur, vn, vm);
+            next = _mm512_madd52hi_epu64(next, vn, vm);
+            _mm512_storeu_si512(t + j * W, cur);
+            cur = next;
+        }
+        _mm512_storeu_si512(t + k * W, cur);
+        // t[0] đã chia hết cho 2^52: đẩy phần cao lên và dịch xuống 1 block
+        for (size_t lane = 0; lane < W; lane++)
+            t[W + lane] += t[lane] >> 52;
+        copy(t + W, t + (k + 1) * W, t);
+        fill(t + k * W, t + (k + 1) * W, 0);
+    }
+
+    // Chuẩn hóa carry, rồi trừ p nếu t >= p (t < 2p)
+    for (size_t lane = 0; lane < W; lane++)
+    {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < k; j++)
+        {
+            uint64_t v = t[j * W + lane] + carry;
+            t[j * W + lane] = v & MASK52;
+            carry = v >> 52;
+        }
+        uint64_t borrow = 0;
+        for (size_t j = 0; j < k; j++)
+        {
+            uint64_t v = t[j * W + lane] - n[j * W + lane] - borrow;
+            out[j * W + lane] = v & MASK52;
+            borrow = v >> 63;
+        }
+        // Còn mượn và không có carry: t < p, giữ nguyên t
+        uint64_t keep = 0 - (uint64_t)(borrow > carry);
+        for (size_t j = 0; j < k; j++)
+            out[j * W + lane] = (t[j * W + lane] & keep) | (out[j * W + lane] & ~keep);
+    }
+}
+#endif
+
+// Lũy thừa mod hàng loạt
+/*
+    @logic
+    1. Chia đầu vào thành từng nhóm LANES phần tử (nhóm cuối đệm làn trống bằng 0)
+    2. Mỗi làn: đưa base về dạng Montgomery, dựng bảng table[v] = base^v (v < 2^w, w = 4)
+    3. Cửa sổ cố định, số cửa sổ tính từ k (kích thước modulus), không từ giá trị số mũ:
+    mọi làn cùng bình phương w lần, rồi nhân với table[v_lane] của riêng làn đó.
+    table[v_lane] được chọn bằng cách quét toàn bộ bảng với mặt nạ theo làn (không đánh chỉ số
+    theo v_lane) --> thời gian và địa chỉ truy cập không phụ thuộc số mũ bí mật
+    4. Đưa kết quả về dạng thường (nhân với 1), ghép các block 52 bit thành BigInt
+*/
+vector<BigInt> BatchModExp::pow(const vector<BigInt> &bases, const vector<BigInt> &exps) const
+{
+    DH_TIME(BATCH_MODEXP);
+    if (bases.size() != exps.size())
+        throw runtime_error("BatchModExp: bases and exps must have the same size!");
+#if !defined(__AVX512IFMA__)
+    vector<BigInt> scalar_results;
+    scalar_results.reserve(bases.size());
+    for (size_t i = 0; i < bases.size(); i++)
+        scalar_results.push_back(BigInt::modular_exponentiation_consttime(bases[i], exps[i], ctx));
+    return scalar_results;
+#else
+    const size_t W = LANES;
+    const int w = 4;
+    const size_t table_size = (size_t)1 << w;
+    const size_t row = k * W;
+
+    vector<BigInt> results(bases.size());
+    LimbBuffer t((k + 1) * W), x(row), res(row), sel(row), one_plain(row, 0);
+    LimbBuffer table(table_size * row);
+    for (size_t lane = 0; lane < W; lane++)
+        one_plain[lane] = 1;
+
+    for (size_t start = 0; start < bases.size(); start += W)
+    {
+        size_t lanes = min(W, bases.size() - start);
+
+        // x = base mod p (công khai), tách thành block 52 bit theo từng làn
+        // Số mũ chép vào e_limbs block 64 bit mỗi làn, e_limbs chỉ theo kích thước modulus
+        // (hoặc kích thước lưu trữ của số mũ nếu dài hơn), không theo bit_length()
+        fill(x.begin(), x.end(), 0);
+        size_t e_limbs = (52 * k + 63) / 64;
+        for (size_t lane = 0; lane < lanes; lane++)
+        {
+            BigInt b = bases[start + lane] < mod ? bases[start + lane] : bases[start + lane] % mod;
+            for (size_t bit = 0, len = b.bit_length(); bit < len; bit++)
+            {
+                if (b.bit(bit))
+                    x[(bit / 52) * W + lane] |= 1ULL << (bit % 52);
+            }
+            e_limbs = max(e_limbs, (exps[start + lane].data.size() + 1) / 2);
+        }
+        LimbBuffer e(W * e_limbs, 0);
+        for (size_t lane = 0; lane < lanes; lane++)
+            BigInt::to_limbs64(exps[start + lane], &e[lane * e_limbs], e_limbs);
+
+        // table[0] = 1 (dạng Montgomery), table[1] = base (dạng Montgomery), table[v] = table[v - 1] * base
+        mul(one_plain.data(), r2.data(), &table[0], t.data());
+        mul(x.data(), r2.data(), &table[row], t.data());
+        for (size_t v = 2; v < table_size; v++)
+            mul(&table[(v - 1) * row], &table[row], &table[v * row], t.data());
+
+        copy(table.begin(), table.begin() + row, res.begin());
+        size_t nbits = e_limbs * 64;
+        size_t windows = (nbits + w - 1) / w;
+        for (size_t win = windows; win-- > 0;)
+        {
+            if (win + 1 != windows)
+            {
+                for (int j = 0; j < w; j++)
+                    mul(res.data(), res.data(), res.data(), t.data());
+            }
+            // Giá trị cửa sổ của từng làn (làn trống: 0)
+            uint64_t values[W];
+            for (size_t lane = 0; lane < W; lane++)
+            {
+                const uint64_t *el = &e[lane * e_limbs];
+                uint64_t value = 0;
+                for (int j = w - 1; j >= 0; j--)
+                {
+                    size_t b = win * w + j;
+                    value = (value << 1) | (b < nbits ? (el[b / 64] >> (b % 64)) & 1 : 0);
+                }
+                values[lane] = value;
+            }
+            // sel = table[values[lane]] từng làn: đọc mọi phần tử bảng, giữ lại bằng mặt nạ so sánh
+            __m512i vval = _mm512_loadu_si512(values);
+            __mmask8 masks[table_size];
+            for (size_t v = 0; v < table_size; v++)
+                masks[v] = _mm512_cmpeq_epi64_mask(vval, _mm512_set1_epi64((long long)v));
+            for (size_t j = 0; j < k; j++)
+            {
+                __m512i acc = _mm512_setzero_si512();
+                for (size_t v = 0; v < table_size; v++)
+                    acc = _mm512_mask_mov_epi64(acc, masks[v], _mm512_loadu_si512(&table[v * row + j * W]));
+                _mm512_storeu_si512(&sel[j * W], acc);
+            }
+            mul(res.data(), sel.data(), res.data(), t.data());
+        }
+
+        // Về dạng thường và ghép block 52 bit
+        mul(res.data(), one_plain.data(), res.data(), t.data());
+        for (size_t lane = 0; lane < lanes; lane++)
+        {
+            LimbBuffer w64((52 * k + 63) / 64 + 1, 0);
+            for (size_t j = 0; j < k; j++)
+            {
+                uint64_t digit = res[j * W + lane];
+                size_t bit = 52 * j;
+                w64[bit / 64] |= digit << (bit % 64);
+                if (bit % 64 > 12)
+                    w64[bit / 64 + 1] |= digit >> (64 - bit % 64);
+            }
+            results[start + lane] = BigInt::from_limbs64(w64.data(), w64.size());
+        }
+    }
+    return results;
+#endif
+}
+
+const char *BatchModExp::kernel_name()
+{
+#if defined(__AVX512IFMA__)
+    return "avx512ifma";
+#else
+    return "scalar";
+#endif
+}
+
+// Thread pool trộm việc
+WorkStealingPool::WorkStealingPool(unsigned threads) : threads(threads)
+{
+    if (this->threads == 0)
+        this->threads = max(1u, thread::hardware_concurrency());
+    queues.reset(new Queue[this->threads]);
+    workers.reserve(this->threads - 1);
+    for (unsigned t = 1; t < this->threads; t++)
+        workers.emplace_back([this, t]()
+                             { worker_loop(t); });
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        lock_guard<mutex> lock(m);
+        stopping = true;
+    }
+    cv_start.notify_all();
+    for (thread &worker : workers)
+        worker.join();
+}
+
+// Luồng nền: chờ thế hệ việc mới, làm, báo xong
+void WorkStealingPool::worker_loop(unsigned self)
+{
+    size_t seen = 0;
+    while (true)
+    {
+        {
+            unique_lock<mutex> lock(m);
+            cv_start.wait(lock, [&]()
+                          { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+        }
+        work(self);
+        {
+            lock_guard<mutex> lock(m);
+            if (--pending == 0)
+                cv_done.notify_one();
+        }
+    }
+}
+
+// Lấy chunk từ hàng đợi của mình trước, rồi lần lượt trộm từ các luồng khác
+/*
+    @logic
+    1. fetch_add trả về chỉ số chunk; vượt end nghĩa là đoạn đó đã hết (có thể vượt nhiều lần, vô hại)
+    2. Duyệt các luồng khác bắt đầu từ self + 1 để các luồng rảnh không cùng trộm 1 chỗ
+*/
+void WorkStealingPool::work(unsigned self)
+{
+    for (unsigned d = 0; d < threads; d++)
+    {
+        Queue &q = queues[(self + d) % threads];
+        while (true)
+        {
+            size_t c = q.next.fetch_add(1, memory_order_relaxed);
+            if (c >= q.end)
+                break;
+            size_t begin = c * job_chunk;
+            try
+            {
+                (*job)(begin, min(begin + job_chunk, job_n));
+            }
+            catch (...)
+            {
+                lock_guard<mutex> lock(error_mutex);
+                if (!error)
+                    error = current_exception();
+            }
+        }
+    }
+}
+
+/*
+    @logic
+    1. Chia ceil(n / chunk) chunk thành threads đoạn liên tiếp gần bằng nhau
+    2. Tăng generation để đánh thức luồng nền, luồng gọi cũng tham gia như luồng 0
+    3. Chờ pending về 0 rồi ném lại ngoại lệ (nếu có)
+*/
+void WorkStealingPool::parallel_for(size_t n, size_t chunk, const function<void(size_t, size_t)> &f)
+{
+    if (n == 0)
+        return;
+    if (chunk == 0)
+        chunk = 1;
+    lock_guard<mutex> call_lock(call_mutex);
+
+    size_t chunks = (n + chunk - 1) / chunk;
+    for (unsigned t = 0; t < threads; t++)
+    {
+        queues[t].next.store(chunks * t / threads, memory_order_relaxed);
+        queues[t].end = chunks * (t + 1) / threads;
+    }
+    job = &f;
+    job_n = n;
+    job_chunk = chunk;
+    error = nullptr;
+    {
+        lock_guard<mutex> lock(m);
+        pending = threads - 1;
+        generation++;
+    }
+    cv_start.notify_all();
+
+    work(0);
+    {
+        unique_lock<mutex> lock(m);
+        cv_done.wait(lock, [this]()
+                     { return pending == 0; });
+    }
+    job = nullptr;
+    if (error)
+        rethrow_exception(error);
+}
+
+// Trao đổi khóa hàng loạt
+KeyExchangeBatch::KeyExchangeBatch(const BigInt &p, const BigInt &g, unsigned threads, size_t chunk)
+    : p(p), g(g), g_table(g, p), peer_exp(p), pool(threads), chunk(chunk == 0 ? 1 : chunk)
+{
+}
+
+vector<BigInt> KeyExchangeBatch::public_keys(const vector<BigInt> &private_keys)
+{
+    DH_TIME(KEY_EXCHANGE_PUBLIC);
+    vector<BigInt> result(private_keys.size());
+    pool.parallel_for(private_keys.size(), chunk, [&](size_t begin, size_t end)
+                      {
+        for (size_t i = begin; i < end; i++)
+            result[i] = g_table.pow_consttime(private_keys[i]); });
+    return result;
+}
+
+// Mỗi chunk đi qua BatchModExp (nhiều làn SIMD cùng lúc khi có IFMA)
+vector<BigInt> KeyExchangeBatch::shared_secrets(const vector<BigInt> &private_keys, const vector<BigInt> &peer_public_keys)
+{
+    DH_TIME(KEY_EXCHANGE_SHARED);
+    if (private_keys.size() != peer_public_keys.size())
+        throw runtime_error("KeyExchangeBatch: key counts do not match!");
+    vector<BigInt> result(private_keys.size());
+    pool.parallel_for(private_keys.size(), chunk, [&](size_t begin, size_t end)
+                      {
+        vector<BigInt> bases(peer_public_keys.begin() + begin, peer_public_keys.begin() + end);
+        vector<BigInt> exps(private_keys.begin() + begin, private_keys.begin() + end);
+        vector<BigInt> part = peer_exp.pow(bases, exps);
+        move(part.begin(), part.end(), result.begin() + begin); });
+    return result;
+}
+
+// Kho số nguyên tố an toàn
+// FNV-1a 64 bit trên các trường của Record (trừ checksum) và 3 * limbs block
+uint64_t PrimeStore::checksum(const Record &record, const uint64_t *limbs)
+{
+    uint64_t h = 0xCBF29CE484222325ULL;
+    auto mix = [&h](const void *data, size_t bytes)
+    {
+        const unsigned char *b = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < bytes; i++)
+        {
+            h ^= b[i];
+            h *= 0x100000001B3ULL;
+        }
+    };
+    mix(&record.bits, sizeof(record.bits));
+    mix(&record.limbs, sizeof(record.limbs));
+    mix(&record.n0_inv, sizeof(record.n0_inv));
+    mix(&record.generator, sizeof(record.generator));
+    mix(limbs, 3 * record.limbs * sizeof(uint64_t));
+    return h;
+}
+
+/*
+    @param path (Đường dẫn file kho)
+    @logic
+    1. mmap chỉ đọc toàn bộ file (Windows: đọc vào bộ đệm)
+    2. Kiểm tra magic, version; duyệt count mục, mỗi mục phải nằm trọn trong file và đúng checksum
+    3. Entry trỏ thẳng vào vùng đã map, không sao chép
+    Mục đang được append ở process khác (count chưa tăng) không được đọc tới
+*/
+PrimeStore::PrimeStore(const string &path)
+{
+#if defined(_WIN32)
+    ifstream in(path, ios::binary);
+    if (!in)
+        throw runtime_error("PrimeStore: cannot open " + path);
+    buffer.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    base = buffer.data();
+    length = buffer.size();
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw runtime_error("PrimeStore: cannot open " + path);
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        throw runtime_error("PrimeStore: cannot stat " + path);
+    }
+    length = (size_t)st.st_size;
+    if (length > 0)
+    {
+        void *mem = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (mem == MAP_FAILED)
+        {
+            close(fd);
+            throw runtime_error("PrimeStore: cannot map " + path);
+        }
+        base = static_cast<const unsigned char *>(mem);
+    }
+    close(fd);
+#endif
+    try
+    {
+        if (length < sizeof(FileHeader))
+            throw runtime_error("PrimeStore: file too small!");
+        const FileHeader *header = reinterpret_cast<const FileHeader *>(base);
+        if (memcmp(header->magic, "DHPRIME", 8) != 0)
+            throw runtime_error("PrimeStore: bad magic!");
+        if (header->version != VERSION)
+            throw runtime_error("PrimeStore: unsupported version!");
+
+        size_t offset = sizeof(FileHeader);
+        for (uint32_t i = 0; i < header->count; i++)
+        {
+            if (length - offset < sizeof(Record))
+                throw runtime_error("PrimeStore: truncated entry!");
+            const Record *record = reinterpret_cast<const Record *>(base + offset);
+            offset += sizeof(Record);
+            size_t bytes = 3 * (size_t)record->limbs * sizeof(uint64_t);
+            if (record->limbs == 0 || record->bits > record->limbs * 64 || length - offset < bytes)
+                throw runtime_error("PrimeStore: truncated entry!");
+            const uint64_t *limbs = reinterpret_cast<const uint64_t *>(base + offset);
+            if (checksum(*record, limbs) != record->checksum)
+                throw runtime_error("PrimeStore: checksum mismatch!");
+            offset += bytes;
+            entries.push_back({record->bits, record->limbs, record->n0_inv, record->generator,
+                               limbs, limbs + record->limbs, limbs + 2 * record->limbs});
+        }
+    }
+    catch (...)
+    {
+#if !defined(_WIN32)
+        if (base)
+            munmap(const_cast<unsigned char *>(base), length);
+#endif
+        throw;
+    }
+}
+
+PrimeStore::~PrimeStore()
+{
+#if !defined(_WIN32)
+    if (base)
+        munmap(const_cast<unsigned char *>(base), length);
+#endif
+}
+
+const PrimeStore::Entry *PrimeStore::find(size_t bits) const
+{
+    for (const Entry &entry : entries)
+    {
+        if (entry.bits == bits)
+            return &entry;
+    }
+    return nullptr;
+}
+
+void PrimeStore::append(const string &path, int bits, unsigned threads)
+{
+    append(path, BigInt::generate_safe_prime_parallel(bits, threads), 4);
+}
+
+/*
+    @param p (Số nguyên tố an toàn), generator (Phần tử sinh)
+    @logic
+    1. Tính hằng số Montgomery 1 lần bằng MontgomeryContext
+    2. Khóa file (flock) để nhiều process sinh cùng lúc không ghi đè nhau
+    3. File rỗng: ghi FileHeader; ghi mục mới ở cuối file rồi mới tăng count
+    --> process đang đọc chỉ thấy mục đã ghi xong
+*/
+void PrimeStore::append(const string &path, const BigInt &p, uint64_t generator)
+{
+    MontgomeryContext ctx(p);
+    size_t k = ctx.limbs();
+    LimbBuffer limbs(3 * k);
+    copy(ctx.n.begin(), ctx.n.end(), limbs.begin());
+    copy(ctx.r_mod.begin(), ctx.r_mod.end(), limbs.begin() + k);
+    copy(ctx.r2_mod.begin(), ctx.r2_mod.end(), limbs.begin() + 2 * k);
+    Record record{(uint32_t)p.bit_length(), (uint32_t)k, ctx.n0_inv, generator, 0};
+    record.checksum = checksum(record, limbs.data());
+
+    fstream file;
+#if !defined(_WIN32)
+    int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+        throw runtime_error("PrimeStore: cannot open " + path);
+    flock(fd, LOCK_EX);
+#endif
+    file.open(path, ios::in | ios::out | ios::binary);
+#if defined(_WIN32)
+    // ios::in | ios::out không tạo file mới: tạo file rỗng (app: không xóa nội dung nếu vừa có
+    // process khác tạo) rồi mở lại
+    if (!file.is_open())
+    {
+        ofstream(path, ios::out | ios::app | ios::binary).close();
+        file.clear();
+        file.open(path, ios::in | ios::out | ios::binary);
+    }
+#endif
+    if (!file.is_open())
+    {
+#if !defined(_WIN32)
+        close(fd);
+#endif
+        throw runtime_error("PrimeStore: cannot open " + path);
+    }
+    FileHeader header{};
+    file.seekg(0, ios::end);
+    if (file.tellg() == 0)
+    {
+        memcpy(header.magic, "DHPRIME", 8);
+        header.version = VERSION;
+        file.seekp(0);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+    else
+    {
+        file.seekg(0);
+        file.read(reinterpret_cast<char *>(&header), sizeof(header));
+        if (!file || memcmp(header.magic, "DHPRIME", 8) != 0 || header.version != VERSION)
+        {
+#if !defined(_WIN32)
+            close(fd);
+#endif
+            throw runtime_error("PrimeStore: cannot append to " + path);
+        }
+    }
+    file.seekp(0, ios::end);
+    file.write(reinterpret_cast<const char *>(&record), sizeof(record));
+    file.write(reinterpret_cast<const char *>(limbs.data()), limbs.size() * sizeof(uint64_t));
+    file.flush();
+    header.count++;
+    file.seekp(0);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.flush();
+    bool ok = (bool)file;
+    file.close();
+#if !defined(_WIN32)
+    fsync(fd);
+    close(fd); // Đóng fd thì nhả khóa flock
+#endif
+    if (!ok)
+        throw runtime_error("PrimeStore: write failed for " + path);
+}
+
+// Kho cặp khóa tạm thời
+EphemeralKeyPool::EphemeralKeyPool(const BigInt &p, const BigInt &g, size_t capacity, size_t low_watermark,
+                                   size_t high_watermark, unsigned threads)
+    : EphemeralKeyPool(g, MontgomeryContext(p), capacity, low_watermark, high_watermark, threads)
+{
+}
+
+EphemeralKeyPool::EphemeralKeyPool(const BigInt &g, const MontgomeryContext &ctx, size_t capacity, size_t low_watermark,
+                                   size_t high_watermark, unsigned threads)
+    : p(ctx.modulus()), g_table(g, ctx)
+{
+    size_t n = 2;
+    while (n < capacity)
+        n <<= 1;
+    mask = n - 1;
+    slots.reset(new Slot[n]);
+    for (size_t i = 0; i < n; i++)
+        slots[i].sequence.store(i, memory_order_relaxed);
+
+    this->high_watermark = (high_watermark == 0 || high_watermark > n) ? n : high_watermark;
+    // low < high: luồng nền được đánh thức ở available() <= low thì còn chỗ để nạp
+    this->low_watermark = min(low_watermark, this->high_watermark - 1);
+    workers.reserve(threads);
+    for (unsigned t = 0; t < threads; t++)
+        workers.emplace_back([this]()
+                             { refill_loop(); });
+}
+
+EphemeralKeyPool::~EphemeralKeyPool()
+{
+    {
+        lock_guard<mutex> lock(wake_mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (thread &worker : workers)
+        worker.join();
+}
+
+EphemeralKeyPool::KeyPair EphemeralKeyPool::make_pair() const
+{
+    BigInt x = BigInt::generate_private_key(p);
+    BigInt y = g_table.pow_consttime(x);
+    return {move(x), move(y)};
+}
+
+/*
+    @logic (hàng đợi vòng có giới hạn, nhiều ghi nhiều đọc, không khóa)
+    1. Ô tại vị trí tail trống khi sequence == tail: giành vị trí bằng CAS trên tail rồi ghi dữ liệu,
+    sau đó đặt sequence = tail + 1 (release) để báo ô đã có dữ liệu
+    2. sequence < tail: ô chưa được đọc xong từ vòng trước --> hàng đợi đầy
+    3. sequence > tail: luồng khác vừa giành vị trí này, đọc lại tail
+*/
+bool EphemeralKeyPool::try_push(KeyPair &pair)
+{
+    size_t pos = tail.load(memory_order_relaxed);
+    Slot *slot;
+    while (true)
+    {
+        slot = &slots[pos & mask];
+        size_t seq = slot->sequence.load(memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0)
+        {
+            if (tail.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+            return false;
+        else
+            pos = tail.load(memory_order_relaxed);
+    }
+    slot->pair = move(pair);
+    slot->sequence.store(pos + 1, memory_order_release);
+    return true;
+}
+
+// Đối xứng với try_push: ô có dữ liệu khi sequence == head + 1; đọc xong đặt sequence = head + dung lượng
+bool EphemeralKeyPool::try_pop(KeyPair &out)
+{
+    size_t pos = head.load(memory_order_relaxed);
+    Slot *slot;
+    while (true)
+    {
+        slot = &slots[pos & mask];
+        size_t seq = slot->sequence.load(memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+        if (diff == 0)
+        {
+            if (head.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+            return false;
+        else
+            pos = head.load(memory_order_relaxed);
+    }
+    out = move(slot->pair);
+    slot->sequence.store(pos + mask + 1, memory_order_release);
+
+    // Tụt xuống ngưỡng thấp: đánh thức luồng nền (khóa rỗng để không lỡ tín hiệu khi luồng nền sắp ngủ)
+    if (available() <= low_watermark)
+    {
+        {
+            lock_guard<mutex> lock(wake_mutex);
+        }
+        wake.notify_all();
+    }
+    return true;
+}
+
+EphemeralKeyPool::KeyPair EphemeralKeyPool::pop()
+{
+    DH_TIME(KEY_POOL_POP);
+    KeyPair pair;
+    if (try_pop(pair))
+    {
+        hits.fetch_add(1, memory_order_relaxed);
+        return pair;
+    }
+    misses.fetch_add(1, memory_order_relaxed);
+    return make_pair();
+}
+
+size_t EphemeralKeyPool::available() const
+{
+    size_t t = tail.load(memory_order_acquire), h = head.load(memory_order_acquire);
+    return t > h ? t - h : 0;
+}
+
+/*
+    @logic
+    1. Hạ độ ưu tiên luồng (Linux: SCHED_IDLE, chỉ chạy khi CPU rảnh)
+    2. Giữ chỗ trước khi tạo cặp: building đếm số cặp đang được tạo, chỉ tạo khi
+    available() + building < high_watermark --> nhiều luồng nền không tạo thừa cặp rồi bỏ đi
+    vì hàng đợi đầy (high_watermark <= dung lượng nên try_push luôn còn ô)
+    3. Đạt high_watermark: ngủ đến khi tụt xuống low_watermark hoặc pool bị hủy
+*/
+void EphemeralKeyPool::refill_loop()
+{
+#if defined(__linux__)
+    sched_param param{};
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+    while (!stopping.load(memory_order_relaxed))
+    {
+        size_t in_flight = building.fetch_add(1, memory_order_acq_rel);
+        if (available() + in_flight >= high_watermark)
+        {
+            building.fetch_sub(1, memory_order_acq_rel);
+            unique_lock<mutex> lock(wake_mutex);
+            wake.wait(lock, [this]()
+                      { return stopping.load() || available() <= low_watermark; });
+            continue;
+        }
+        auto start = chrono::steady_clock::now();
+        KeyPair pair = make_pair();
+        uint64_t ns = (uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+        // Chỉ tính thời gian của cặp thực sự vào hàng đợi (refill_rate)
+        if (try_push(pair))
+        {
+            busy_ns.fetch_add(ns, memory_order_relaxed);
+            produced.fetch_add(1, memory_order_relaxed);
+        }
+        building.fetch_sub(1, memory_order_acq_rel);
+    }
+}
+
+EphemeralKeyPool::Stats EphemeralKeyPool::stats() const
+{
+    Stats s;
+    s.hits = hits.load(memory_order_relaxed);
+    s.misses = misses.load(memory_order_relaxed);
+    s.produced = produced.load(memory_order_relaxed);
+    uint64_t ns = busy_ns.load(memory_order_relaxed);
+    s.refill_rate = ns ? s.produced * 1e9 / ns : 0.0;
+    s.available = available();
+    return s;
 }
@@ -6,16 +6,384 @@
 #include <algorithm>
 #include <ctime>
 #include <random>
+#include <stdexcept>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <exception>
+#include <deque>
+#include <chrono>
+#include <string>
 
 using namespace std;
 
+// Số nguyên 128 bit (GCC/Clang): chứa trọn tích 64 x 64 bit
+typedef unsigned __int128 uint128_t;
+
+class MontgomeryContext;
+class BigInt;
+class PrimeStore;
+
+// Đo đạc đường nóng: bộ đếm theo thread và histogram độ trễ (thang log2) cho các hàm public
+// Chỉ bật khi biên dịch với DH_INSTRUMENT (CMake: -DDH_INSTRUMENT=ON); khi tắt, các macro
+// DH_COUNT / DH_TIME rỗng --> không sinh mã nào trên đường nóng, snapshot() trả về toàn 0.
+// Mỗi thread ghi vào khối đếm riêng (không tranh chấp), snapshot() cộng dồn mọi thread
+// (kể cả thread đã kết thúc).
+class Instrumentation
+{
+public:
+    enum Counter
+    {
+        CANDIDATES,      // Ứng viên số nguyên tố được xét (sieve_search)
+        SIEVE_REJECTS,   // Ứng viên bị sàng số nguyên tố nhỏ loại
+        MR_ROUNDS,       // Số vòng Miller-Rabin
+        MUL_CALLS,       // Phép nhân số lớn (multiply_to)
+        SQR_CALLS,       // Phép bình phương số lớn (square)
+        REDUCE_CALLS,    // Rút gọn Barrett
+        DIV_CALLS,       // Phép chia Knuth (divmod)
+        MONT_MUL_CALLS,  // Nhân Montgomery
+        MONT_SQR_CALLS,  // Bình phương Montgomery
+        LIMBS_PROCESSED, // Tổng số block 64 bit đi qua các phép trên
+        COUNTER_COUNT
+    };
+    enum Timer
+    {
+        MODEXP,                      // modular_exponentiation(base, exp, mod)
+        MODEXP_MONTGOMERY,           // modular_exponentiation(base, exp, ctx)
+        MODEXP_CONSTTIME,            // modular_exponentiation_consttime
+        MILLER_RABIN,                // is_prime_by_Miller_Rabin
+        BAILLIE_PSW,                 // is_prime_by_Baillie_PSW
+        GENERATE_PRIME,              // generate_prime
+        GENERATE_SAFE_PRIME,         // generate_safe_prime
+        GENERATE_SAFE_PRIME_PARALLEL, // generate_safe_prime_parallel
+        PRIVATE_KEY,                 // generate_private_key
+        FIXED_BASE_POW,              // FixedBaseTable::pow
+        FIXED_BASE_POW_CONSTTIME,    // FixedBaseTable::pow_consttime
+        BATCH_MODEXP,                // BatchModExp::pow
+        KEY_EXCHANGE_PUBLIC,         // KeyExchangeBatch::public_keys
+        KEY_EXCHANGE_SHARED,         // KeyExchangeBatch::shared_secrets
+        KEY_POOL_POP,                // EphemeralKeyPool::pop
+        TIMER_COUNT
+    };
+    static const size_t BUCKETS = 40; // Bucket i: [2^i, 2^(i+1)) ns, bucket cuối gom phần còn lại
+
+    struct Snapshot
+    {
+        uint64_t counters[COUNTER_COUNT];
+        uint64_t calls[TIMER_COUNT];
+        uint64_t total_ns[TIMER_COUNT];
+        uint64_t buckets[TIMER_COUNT][BUCKETS];
+    };
+
+    static constexpr bool enabled()
+    {
+#if defined(DH_INSTRUMENT)
+        return true;
+#else
+        return false;
+#endif
+    }
+    static const char *counter_name(Counter c);
+    static const char *timer_name(Timer t);
+
+    // Cộng dồn mọi thread; reset() đưa mọi bộ đếm về 0
+    static Snapshot snapshot();
+    static void reset();
+    static string to_text(const Snapshot &s);
+    static string to_json(const Snapshot &s);
+
+    // Đường nóng (chỉ gọi qua macro DH_COUNT / DH_TIME)
+    static void add(Counter c, uint64_t n);
+    static void record(Timer t, uint64_t ns);
+
+    // Đo thời gian từ lúc tạo đến lúc hủy (cả khi thoát bằng ngoại lệ)
+    class ScopedTimer
+    {
+    private:
+        Timer timer;
+        chrono::steady_clock::time_point start;
+
+    public:
+        explicit ScopedTimer(Timer t) : timer(t), start(chrono::steady_clock::now()) {}
+        ~ScopedTimer()
+        {
+            record(timer, (uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+        }
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+    };
+
+private:
+    struct ThreadBlock;
+    static mutex &registry_mutex();
+    static vector<ThreadBlock *> &registry();
+    static ThreadBlock &retired();
+    static ThreadBlock &local();
+};
+
+#if defined(DH_INSTRUMENT)
+#define DH_COUNT(counter, n) Instrumentation::add(Instrumentation::counter, (n))
+#define DH_TIME(timer) Instrumentation::ScopedTimer dh_scoped_timer(Instrumentation::timer)
+#else
+#define DH_COUNT(counter, n) ((void)0)
+#define DH_TIME(timer) ((void)0)
+#endif
+
+// Vùng nhớ bump (arena) cho các số tạm của BigInt
+// Mỗi thread có 1 arena riêng (local()) --> không tranh chấp bộ cấp phát chung giữa các thread.
+// Chỉ cấp phát từ arena khi có Scope đang mở trên thread đó; giải phóng từng khối là no-op,
+// toàn bộ vùng nhớ cấp trong Scope được thu hồi 1 lần khi Scope đóng (lùi về mốc lúc mở).
+// Vì vậy số tạo trong Scope không được sống lâu hơn Scope: kết quả trả ra ngoài phải qua detach().
+// Vượt giới hạn limit_bytes thì cấp phát heap như bình thường (đếm trong heap_fallbacks).
+class LimbArena
+{
+public:
+    static const size_t CHUNK_BYTES = 256 * 1024;
+    static const size_t DEFAULT_LIMIT = 64 * 1024 * 1024;
+
+    struct Stats
+    {
+        size_t used_bytes;     // Đang dùng (tính từ các Scope đang mở)
+        size_t peak_bytes;     // Cao nhất từ lúc tạo / reset_peak()
+        size_t capacity_bytes; // Tổng các chunk đã xin từ heap
+        size_t limit_bytes;
+        size_t heap_fallbacks; // Số lần vượt giới hạn, phải cấp phát heap
+    };
+
+private:
+    struct Chunk
+    {
+        unique_ptr<unsigned char[]> mem;
+        size_t size;
+    };
+    struct Mark
+    {
+        size_t chunk, offset, used;
+    };
+
+    vector<Chunk> chunks;
+    size_t current = 0; // Chunk đang cấp phát
+    size_t offset = 0;  // Vị trí đầu vùng trống trong chunk hiện tại
+    size_t used = 0, peak = 0, capacity = 0, limit, fallbacks = 0;
+
+    static LimbArena *&active_slot();
+
+public:
+    explicit LimbArena(size_t limit_bytes = DEFAULT_LIMIT) : limit(limit_bytes) {}
+    LimbArena(const LimbArena &) = delete;
+    LimbArena &operator=(const LimbArena &) = delete;
+
+    // Arena riêng của thread hiện tại
+    static LimbArena &local();
+    // Arena của Scope trong cùng đang mở trên thread hiện tại (nullptr: cấp phát heap)
+    static LimbArena *active() { return active_slot(); }
+
+    // Cấp phát bytes byte (căn 16), nullptr nếu vượt giới hạn
+    void *allocate(size_t bytes);
+    // Nới khối p (khối cuối cùng) từ old_bytes lên new_bytes tại chỗ, false nếu không được
+    bool extend(void *p, size_t old_bytes, size_t new_bytes);
+
+    Stats stats() const;
+    void reset_peak() { peak = used; }
+    void set_limit(size_t limit_bytes) { limit = limit_bytes; }
+
+    // Sao chép x ra vùng nhớ heap để trả ra ngoài Scope
+    static BigInt detach(const BigInt &x);
+
+    // Mở arena cho thread hiện tại; đóng thì lùi arena về mốc lúc mở và khôi phục arena trước đó
+    class Scope
+    {
+    private:
+        LimbArena &arena;
+        LimbArena *previous;
+        Mark mark;
+
+    public:
+        explicit Scope(LimbArena &arena = LimbArena::local());
+        ~Scope();
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    };
+
+    // Tạm tắt arena trên thread hiện tại (kể cả khi đang trong Scope):
+    // đối tượng sống lâu (bảng dựng sẵn, cache) tạo trong lúc này cấp phát heap
+    class Suspend
+    {
+    private:
+        LimbArena *saved;
+
+    public:
+        Suspend();
+        ~Suspend();
+        Suspend(const Suspend &) = delete;
+        Suspend &operator=(const Suspend &) = delete;
+    };
+
+    // Cấp phát cho container chuẩn: 16 byte đầu khối ghi arena sở hữu (nullptr: heap)
+    static void *allocate_tagged(size_t bytes);
+    static void deallocate_tagged(void *p) noexcept;
+};
+
+// Allocator cho vector dùng LimbArena khi có Scope đang mở
+template <class T>
+struct ArenaAllocator
+{
+    typedef T value_type;
+
+    ArenaAllocator() = default;
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U> &) {}
+
+    T *allocate(size_t n) { return static_cast<T *>(LimbArena::allocate_tagged(n * sizeof(T))); }
+    void deallocate(T *p, size_t) noexcept { LimbArena::deallocate_tagged(p); }
+
+    template <class U>
+    bool operator==(const ArenaAllocator<U> &) const { return true; }
+    template <class U>
+    bool operator!=(const ArenaAllocator<U> &) const { return false; }
+};
+
+// Mảng block 64 bit cho các kernel Montgomery / nhân (cấp phát qua LimbArena)
+typedef vector<uint64_t, ArenaAllocator<uint64_t>> LimbBuffer;
+
+// Mảng block 32 bit của BigInt
+// Giữ tối đa INLINE_LIMBS block ngay trong đối tượng (mọi số vừa uint64_t) --> không cấp phát heap,
+// chỉ cấp phát khi số dài hơn. Giao diện là phần của vector<uint32_t> mà BigInt dùng.
+class LimbVector
+{
+public:
+    static const size_t INLINE_LIMBS = 2;
+
+private:
+    uint32_t *ptr; // Trỏ vào inline_buf, vùng nhớ heap hoặc arena
+    size_t len;
+    size_t cap;
+    LimbArena *arena; // Arena sở hữu ptr (nullptr: heap hoặc inline_buf)
+    uint32_t inline_buf[INLINE_LIMBS];
+
+    bool is_inline() const { return ptr == inline_buf; }
+    void grow(size_t min_cap); // Cấp phát lại, giữ nguyên len block đầu
+    void release();            // Trả vùng nhớ ngoài (heap: delete[], arena: no-op)
+
+public:
+    LimbVector() : ptr(inline_buf), len(0), cap(INLINE_LIMBS), arena(nullptr) {}
+    LimbVector(const LimbVector &other);
+    LimbVector(LimbVector &&other) noexcept;
+    LimbVector &operator=(const LimbVector &other);
+    LimbVector &operator=(LimbVector &&other) noexcept;
+    ~LimbVector() { release(); }
+
+    size_t size() const { return len; }
+    bool empty() const { return len == 0; }
+    uint32_t &operator[](size_t i) { return ptr[i]; }
+    const uint32_t &operator[](size_t i) const { return ptr[i]; }
+    uint32_t *data() { return ptr; }
+    const uint32_t *data() const { return ptr; }
+    uint32_t *begin() { return ptr; }
+    const uint32_t *begin() const { return ptr; }
+    uint32_t *end() { return ptr + len; }
+    const uint32_t *end() const { return ptr + len; }
+    uint32_t &back() { return ptr[len - 1]; }
+    const uint32_t &back() const { return ptr[len - 1]; }
+
+    void push_back(uint32_t value)
+    {
+        if (len == cap)
+            grow(len + 1);
+        ptr[len++] = value;
+    }
+    void pop_back() { len--; }
+    void reserve(size_t n)
+    {
+        if (n > cap)
+            grow(n);
+    }
+    void resize(size_t n, uint32_t value = 0);
+    void assign(size_t n, uint32_t value);
+    void assign(const uint32_t *first, const uint32_t *last);
+
+    bool operator==(const LimbVector &other) const;
+};
+
+// Thuật toán kiểm tra số nguyên tố khi sinh số nguyên tố
+enum class PrimalityTest
+{
+    MILLER_RABIN, // 7 vòng Miller-Rabin với cơ số ngẫu nhiên
+    BAILLIE_PSW   // Miller-Rabin cơ số 2 + Lucas mạnh (tham số Selfridge), chỉ khoảng 1/2 chi phí
+};
+
 class BigInt
 {
 private:
     static const uint64_t BASE = (1ULL << 32); // 2^32: Cơ số (từng block trong data)
-    vector<uint32_t> data;
+    LimbVector data;
     void trim(); // Xóa số "0" ở đầu
 
+    // Bộ sinh ngẫu nhiên riêng của thread hiện tại (seed 1 lần)
+    static mt19937_64 &rng();
+
+    // Bảng các số nguyên tố lẻ nhỏ dùng để sàng ứng viên
+    static const vector<uint32_t> &small_primes();
+    // Tìm số nguyên tố (hoặc số nguyên tố an toàn 2q + 1) bằng sàng số nguyên tố nhỏ
+    // stop != nullptr: dừng sớm và trả về 0 khi *stop được bật
+    static BigInt sieve_search(int bits, bool safe, PrimalityTest test, const atomic<bool> *stop = nullptr);
+
+    // 1 vòng Miller-Rabin với cơ số a_m (dạng Montgomery), n - 1 = 2^s * d
+    static bool miller_rabin_round(const MontgomeryContext &ctx, const LimbBuffer &a_m, const BigInt &d, int s,
+                                   const LimbBuffer &minus_one_m, uint64_t *scratch);
+    // Kiểm tra Lucas mạnh với tham số Selfridge (P = 1, Q = (1 - D) / 4), n lẻ, không chính phương
+    static bool is_strong_lucas_probable_prime(const BigInt &n, const MontgomeryContext &ctx, int64_t D);
+    // Căn bậc hai nguyên floor(sqrt(n)) bằng phép lặp Newton
+    static BigInt isqrt(const BigInt &n);
+
+    // Chuyển đổi giữa block 32 bit (data) và mảng k block 64 bit cho các kernel nhân
+    static void to_limbs64(const BigInt &a, uint64_t *out, size_t k);
+    static BigInt from_limbs64(const uint64_t *in, size_t k);
+    // Ghi k block 64 bit vào data của chính đối tượng (dùng lại vùng nhớ sẵn có)
+    void assign_limbs64(const uint64_t *in, size_t k);
+    // out = a * b (out có thể trùng a hoặc b)
+    static void multiply_to(const BigInt &a, const BigInt &b, BigInt &out);
+    // Bình phương mảng n block 64 bit vào r (2n block)
+    static void square_limbs64(const uint64_t *x, size_t n, uint64_t *r);
+    // Ký hiệu Jacobi (a / n) trên mảng k block 64 bit (n lẻ, a < n); a và n bị ghi đè
+    static int jacobi_limbs64(uint64_t *a, uint64_t *n, size_t k);
+
+    // Kernel nhân trên mảng block 64 bit, không cấp phát (mọi vùng nhớ tạm lấy từ scratch)
+    // Ngưỡng đo trên máy x86-64 (block 64 bit, xem mul_limbs64)
+    static const size_t KARATSUBA_CUTOFF = 32; // < ngưỡng: nhân trường học (2048 bit)
+    static const size_t TOOM3_CUTOFF = 96;     // >= ngưỡng: Toom-Cook 3 (~6144 bit trở lên)
+    // r (na + nb block) = a * b; a == b và na == nb thì dùng nhánh bình phương
+    static void mul_limbs64(const uint64_t *a, size_t na, const uint64_t *b, size_t nb, uint64_t *r, uint64_t *scratch);
+    static void karatsuba_limbs64(const uint64_t *a, size_t na, const uint64_t *b, size_t nb, uint64_t *r, uint64_t *scratch);
+    static void toom3_limbs64(const uint64_t *a, size_t na, const uint64_t *b, size_t nb, uint64_t *r, uint64_t *scratch);
+    // Số block scratch đủ cho mul_limbs64 với max(na, nb) = n
+    static size_t mul_scratch_limbs(size_t n);
+    // r[0..n) += x[0..nx) (nx <= n), trả về carry; r[0..n) -= x[0..nx), trả về borrow
+    static uint64_t add_limbs64(uint64_t *r, size_t n, const uint64_t *x, size_t nx);
+    static uint64_t sub_limbs64(uint64_t *r, size_t n, const uint64_t *x, size_t nx);
+
+    // Chuyển đổi thập phân chia để trị: tách số theo lũy thừa 10^(9 * 2^i) (cache theo thread)
+    // Số có <= RADIX_DC_LIMBS block thì chia / nhân trực tiếp theo cơ số 10^9
+    static const size_t RADIX_DC_LIMBS = 96; // ~3072 bit, đo trên x86-64
+    struct Pow10Level; // 10^(9 * 2^i) và hằng số Barrett mu của nó
+    static const Pow10Level &pow10_level(size_t i);
+    // q = a / 10^(9 * 2^i), r = a % 10^(9 * 2^i) bằng Barrett (a < power^2)
+    static void divmod_pow10(const BigInt &a, const Pow10Level &level, BigInt &q, BigInt &r);
+    // Ghi x ra out: put_decimal không có số 0 ở đầu (trả về số chữ số),
+    // put_decimal_padded đủ 9 * 2^i chữ số (x < 10^(9 * 2^i))
+    static size_t put_decimal(const BigInt &x, char *out);
+    static void put_decimal_padded(const BigInt &x, size_t i, char *out);
+    // out = giá trị của n chữ số thập phân s[0..n)
+    static void parse_decimal(const char *s, size_t n, BigInt &out);
+
+    friend class MontgomeryContext;
+    friend class BatchModExp;
+    friend class FixedBaseTable;
+    friend class PrimeStore;
+
 public:
     // Đây là 1 constructor tiện ích dùng để hỗ trợ khởi tạo các giá trị nhỏ
     // Vì unit64_t là kiểu dữ liệu lớn nhất được hỗ trợ nguyên bản
@@ -33,12 +401,22 @@ public:
     bool operator==(const BigInt &other) const;
     bool operator>=(const BigInt &other) const;
 
+    // So sánh trực tiếp với số nguyên nhỏ (không dựng BigInt tạm)
+    bool operator==(uint64_t small) const;
+    bool operator<(uint64_t small) const;
+    bool operator>(uint64_t small) const;
+    bool is_zero() const { return data.empty(); }
+    bool is_one() const { return data.size() == 1 && data[0] == 1; }
+    bool is_odd() const { return !data.empty() && (data[0] & 1); }
+
     // Toán tử cộng - trừ - nhân - chia - mod (native)
     BigInt operator+(const BigInt &other) const;
     BigInt operator-(const BigInt &other) const;
     BigInt operator*(const BigInt &other) const;
     BigInt operator/(const BigInt &other) const;
     BigInt operator%(const BigInt &mod) const;
+    // Phép chia lấy cả thương và dư (Knuth Algorithm D)
+    static void divmod(const BigInt &a, const BigInt &b, BigInt &quotient, BigInt &remainder);
 
     // Toán tử cộng - nhận (uint64_t)
     BigInt operator*(uint64_t small) const;
@@ -46,29 +424,455 @@ public:
 
     // Toán tử dịch bit
     BigInt operator>>(int shift) const;
+    BigInt operator<<(int shift) const;
+
+    // Toán tử gán kết hợp: tính tại chỗ trên data, chỉ cấp phát khi số dài ra quá dung lượng
+    BigInt &operator+=(const BigInt &other);
+    BigInt &operator-=(const BigInt &other);
+    BigInt &operator*=(const BigInt &other);
+    BigInt &operator%=(const BigInt &mod);
+    BigInt &operator+=(uint64_t small);
+    BigInt &operator*=(uint64_t small);
+    BigInt &operator<<=(int shift);
+    BigInt &operator>>=(int shift);
+    // *this = *this * mul + add trong 1 lượt duyệt
+    BigInt &mul_add_small(uint32_t mul, uint32_t add);
+
+    // Toán hạng là giá trị tạm (rvalue): tính tại chỗ trên vùng nhớ của nó thay vì tạo số mới
+    friend BigInt operator+(BigInt &&a, const BigInt &b) { return move(a += b); }
+    friend BigInt operator+(const BigInt &a, BigInt &&b) { return move(b += a); }
+    friend BigInt operator+(BigInt &&a, BigInt &&b) { return move(a += b); }
+    friend BigInt operator-(BigInt &&a, const BigInt &b) { return move(a -= b); }
+    friend BigInt operator+(BigInt &&a, uint64_t small) { return move(a += small); }
+    friend BigInt operator*(BigInt &&a, uint64_t small) { return move(a *= small); }
+    friend BigInt operator>>(BigInt &&a, int shift) { return move(a >>= shift); }
+    friend BigInt operator<<(BigInt &&a, int shift) { return move(a <<= shift); }
+
+    // Số dư khi chia cho số 32 bit (không cấp phát)
+    uint32_t mod_small(uint32_t m) const;
+    // Chia tại chỗ cho số 32 bit, trả về số dư
+    uint32_t div_small(uint32_t d);
+
+    // Số bit có nghĩa và đọc bit thứ i (không sửa dữ liệu)
+    size_t bit_length() const;
+    bool bit(size_t i) const;
 
     // Toán tử I/O
     friend ostream &operator<<(ostream &os, const BigInt &data);
 
+    // Chuyển đổi chuỗi trên bộ đệm do người gọi cấp (không tạo string trung gian)
+    // decimal_size / hex_size: số ký tự tối đa cần cho to_decimal / to_hex
+    // to_decimal / to_hex trả về số ký tự đã ghi (không thêm '\0'), cap nhỏ hơn cận trên thì báo lỗi
+    size_t decimal_size() const;
+    size_t hex_size() const;
+    size_t to_decimal(char *buf, size_t cap) const;
+    size_t to_hex(char *buf, size_t cap) const;
+    string to_string() const;
+    string to_hex_string() const;
+    // Đọc tại chỗ vào data (bỏ qua ký tự không phải chữ số như constructor chuỗi)
+    BigInt &assign_decimal(const char *s, size_t n);
+    BigInt &assign_hex(const char *s, size_t n);
+    static BigInt from_hex(const string &hexString);
+
+    // Mã hóa nhị phân độ dài cố định (khóa công khai / bí mật chung trên đường truyền)
+    // BIG: byte cao nhất đứng đầu (RFC 3526, đệm 0 bên trái tới len byte); LITTLE: ngược lại
+    enum class ByteOrder
+    {
+        BIG,
+        LITTLE
+    };
+    // Số byte có nghĩa (0 với số 0)
+    size_t byte_length() const;
+    // Ghi đúng len byte vào out (đệm 0), số cần nhiều hơn len byte thì báo lỗi
+    void to_bytes(uint8_t *out, size_t len, ByteOrder order = ByteOrder::BIG) const;
+    // Đọc len byte thẳng vào data (dùng lại vùng nhớ sẵn có)
+    BigInt &assign_bytes(const uint8_t *in, size_t len, ByteOrder order = ByteOrder::BIG);
+    static BigInt from_bytes(const uint8_t *in, size_t len, ByteOrder order = ByteOrder::BIG);
+    // Theo lô: phần tử i nằm ở out[i * width .. (i + 1) * width) của 1 bộ đệm liên tục
+    static void to_bytes_batch(const vector<BigInt> &values, uint8_t *out, size_t width, ByteOrder order = ByteOrder::BIG);
+    // values được resize về count phần tử, phần tử sẵn có được đọc tại chỗ
+    static void from_bytes_batch(const uint8_t *in, size_t width, size_t count, vector<BigInt> &values, ByteOrder order = ByteOrder::BIG);
+
     // Thuật toán nhân Karatsuba
     static BigInt karatsuba_multiply(const BigInt &a, const BigInt &b);
+    // Bình phương (mỗi tích chéo chỉ tính 1 lần)
+    static BigInt square(const BigInt &a);
     // Phép nhân và mod
-    static BigInt mod_mul(BigInt a, BigInt b, const BigInt &mod);
+    static BigInt mod_mul(const BigInt &a, const BigInt &b, const BigInt &mod);
+    // Phép nhân và mod với ngữ cảnh Montgomery dựng sẵn (không cần phép chia)
+    static BigInt mod_mul(const BigInt &a, const BigInt &b, const MontgomeryContext &ctx);
     // Thuật toán Barrett Mod
     static BigInt barrett_mod(const BigInt &a, const BigInt &mod);
     // Hàm modular_exponentiation
-    static BigInt modular_exponentiation(BigInt base, BigInt exp, const BigInt &mod);
+    static BigInt modular_exponentiation(const BigInt &base, const BigInt &exp, const BigInt &mod);
+    // Hàm modular_exponentiation với ngữ cảnh Montgomery dựng sẵn
+    static BigInt modular_exponentiation(const BigInt &base, const BigInt &exp, const MontgomeryContext &ctx);
+    // Lũy thừa mod thời gian hằng cho số mũ bí mật (khóa riêng), modulus bắt buộc lẻ
+    // Thời gian không phụ thuộc giá trị exp (xem MontgomeryContext::pow_consttime)
+    static BigInt modular_exponentiation_consttime(const BigInt &base, const BigInt &exp, const BigInt &mod);
+    static BigInt modular_exponentiation_consttime(const BigInt &base, const BigInt &exp, const MontgomeryContext &ctx);
+    // Độ rộng cửa sổ (window) cho số mũ có exp_bits bit
+    static int window_width(size_t exp_bits);
 
     // Hàm random bit
     static BigInt random_bits(int bits);
+    // Seed lại bộ sinh ngẫu nhiên của thread hiện tại (benchmark / tái lập kết quả, không dùng cho khóa thật)
+    static void seed_random(uint64_t seed);
     // Hàm kiểm tra số nguyên tố (Áp dụng thuật toán Miller-Rabin)
     static bool is_prime_by_Miller_Rabin(const BigInt &n, int iterations = 7);
+    // Hàm kiểm tra số nguyên tố Baillie-PSW (không có phản ví dụ đã biết, đúng tuyệt đối với n < 2^64)
+    static bool is_prime_by_Baillie_PSW(const BigInt &n);
+    // Kiểm tra số nguyên tố theo thuật toán được chọn
+    static bool is_probable_prime(const BigInt &n, PrimalityTest test);
     // Hàm tạo số nguyên tố p
-    static BigInt generate_prime(int bits = 512);
+    static BigInt generate_prime(int bits = 512, PrimalityTest test = PrimalityTest::MILLER_RABIN);
     // Hàm tạo số số nguyên tố an toàn
-    static BigInt generate_safe_prime(int bits = 512);
+    static BigInt generate_safe_prime(int bits = 512, PrimalityTest test = PrimalityTest::MILLER_RABIN);
+    // Hàm tạo số nguyên tố an toàn trên nhiều thread (threads = 0: theo số core)
+    static BigInt generate_safe_prime_parallel(int bits = 512, unsigned threads = 0,
+                                               PrimalityTest test = PrimalityTest::MILLER_RABIN);
     // Hàm sinh khóa riêng tư
-    static BigInt generate_private_key(BigInt p);
+    static BigInt generate_private_key(const BigInt &p);
+
+    // Ký hiệu Jacobi (a / n), n lẻ dương: trả về -1, 0 hoặc 1
+    static int jacobi(const BigInt &a, const BigInt &n);
+    // Kiểm tra khóa công khai y của bên kia với số nguyên tố an toàn p = 2q + 1:
+    // 1 < y < p - 1 và y thuộc nhóm con cấp q (y là thặng dư bậc hai <=> (y / p) = 1)
+    // Rẻ hơn nhiều so với kiểm tra y^q mod p = 1 (không có phép lũy thừa nào)
+    static bool validate_public_key(const BigInt &y, const BigInt &p);
+    // Kiểm tra hàng loạt: result[i] = validate_public_key(ys[i], p), dùng chung p dạng block 64 bit
+    static vector<bool> validate_public_key_batch(const vector<BigInt> &ys, const BigInt &p);
+
+};
 
+// Ngữ cảnh Montgomery cho một modulus lẻ cố định
+// Dựng một lần cho mỗi modulus (R = 2^(64k), R^2 mod p, -p^-1 mod 2^64),
+// sau đó mỗi phép nhân-mod chỉ tốn khoảng 1 phép nhân thay vì 1 phép chia.
+class MontgomeryContext
+{
+private:
+    BigInt mod;               // Modulus p (bắt buộc lẻ)
+    size_t k;                 // Số block 64 bit của p
+    uint64_t n0_inv;          // -p^-1 mod 2^64
+    LimbBuffer n;             // p dạng k block 64 bit
+    LimbBuffer r_mod;         // R mod p (số 1 trong dạng Montgomery), đủ k block
+    LimbBuffer r2_mod;        // R^2 mod p, đủ k block
+
+    // t (k + 1 block, < 2p) --> out = t mod p
+    void reduce_final(const uint64_t *t, uint64_t *out) const;
+
+    friend class BigInt;
+    friend class PrimeStore;
+
+public:
+    explicit MontgomeryContext(const BigInt &mod);
+    // Dựng từ hằng số tính sẵn (k block 64 bit mỗi mảng), chỉ sao chép, không có phép chia
+    MontgomeryContext(const uint64_t *modulus, size_t limbs, uint64_t inv, const uint64_t *r1, const uint64_t *r2);
+
+    const BigInt &modulus() const { return mod; }
+    size_t limbs() const { return k; }
+    // Số block vùng nhớ tạm cần cho mul / sqr
+    size_t scratch_size() const { return 2 * k + 2; }
+
+    // Kernel CIOS: out = a * b * R^-1 mod p
+    // a, b, out là mảng k block 64 bit (a, b < p); scratch có scratch_size() block
+    void mul(const uint64_t *a, const uint64_t *b, uint64_t *out, uint64_t *scratch) const;
+    // Bình phương: out = a * a * R^-1 mod p (mỗi tích chéo chỉ tính 1 lần)
+    void sqr(const uint64_t *a, uint64_t *out, uint64_t *scratch) const;
+
+    // Chuyển đổi giữa dạng thường và dạng Montgomery (mảng k block 64 bit)
+    LimbBuffer to_mont(const BigInt &a) const;
+    BigInt from_mont(const LimbBuffer &a) const;
+    const LimbBuffer &one() const { return r_mod; }
+
+    // Lũy thừa trong dạng Montgomery: trả về base_m^exp (dạng Montgomery)
+    // pow: cửa sổ trượt (sliding window), chỉ lưu các lũy thừa lẻ
+    LimbBuffer pow(const LimbBuffer &base_m, const BigInt &exp) const;
+    // pow_consttime: cửa sổ cố định cho số mũ bí mật, số vòng lặp tính từ số block của modulus,
+    // mỗi cửa sổ đọc toàn bộ bảng --> thời gian và địa chỉ truy cập không phụ thuộc giá trị exp
+    LimbBuffer pow_consttime(const LimbBuffer &base_m, const BigInt &exp) const;
+};
+
+// Bảng lũy thừa dựng sẵn cho cơ số cố định g (phần tử sinh) theo modulus p
+// Lưu g^(v * 2^(w*i)) với mọi cửa sổ i và mọi v trong [1, 2^w)
+// --> g^x chỉ cần khoảng n/w phép nhân, không có phép bình phương nào.
+// Dựng 1 lần cho mỗi cặp (g, p); sau đó chỉ đọc nên dùng chung được giữa các thread.
+class FixedBaseTable
+{
+private:
+    MontgomeryContext ctx;
+    BigInt base;             // Cơ số g
+    int w;                   // Độ rộng cửa sổ (bit)
+    size_t windows;          // Số cửa sổ, phủ tối đa windows * w bit số mũ
+    LimbBuffer table;        // windows * (2^w - 1) phần tử, mỗi phần tử k block 64 bit (dạng Montgomery)
+
+public:
+    // window: độ rộng cửa sổ, quyết định bộ nhớ bảng (~ exp_bits / w * (2^w - 1) * |p|)
+    // exp_bits: độ dài số mũ tối đa (mặc định bằng số bit của p)
+    FixedBaseTable(const BigInt &g, const BigInt &p, int window = 4, size_t exp_bits = 0);
+    // Dùng ngữ cảnh Montgomery có sẵn cho p (ví dụ DHGroup::context())
+    FixedBaseTable(const BigInt &g, const MontgomeryContext &ctx, int window = 4, size_t exp_bits = 0);
+
+    // g^exp mod p
+    // pow: bỏ qua cửa sổ 0, đánh chỉ số bảng theo giá trị cửa sổ (chỉ dùng cho số mũ công khai)
+    // pow_consttime: cho số mũ bí mật (khóa riêng), mọi cửa sổ đều nhân 1 lần và đọc toàn bộ bảng của cửa sổ
+    BigInt pow(const BigInt &exp) const;
+    BigInt pow_consttime(const BigInt &exp) const;
+
+    const MontgomeryContext &context() const { return ctx; }
+    size_t memory_bytes() const { return table.size() * sizeof(uint64_t); }
+};
+
+// Lũy thừa mod hàng loạt với cùng modulus p (ví dụ nhiều g^x mod p, y^x mod p cùng lúc)
+// LANES phép lũy thừa chạy song song trên các làn SIMD:
+//  - Số được biểu diễn theo cơ số 2^52 (khớp với lệnh AVX-512 IFMA vpmadd52lo/hi)
+//  - Bố trí xen kẽ theo làn: block j của làn L nằm ở vị trí [j * LANES + L]
+//  - Chỉ bật khi biên dịch có AVX-512 IFMA (__AVX512IFMA__); ngược lại lần lượt dùng
+//    MontgomeryContext::pow_consttime cho từng phần tử (số mũ thường là khóa riêng;
+//    nhanh hơn giả lập làn 52 bit bằng vòng lặp vô hướng)
+// Không có IFMA (bản dựng mặc định, máy chỉ có AVX2) thì pow KHÔNG nhanh hơn gọi
+// modular_exponentiation_consttime từng phần tử: chỉ có kernel 8 làn, không có bản 4 / 16 làn.
+// Kernel AVX2 (vpmuludq, cơ số 2^26 / 2^28) cần ~3 lệnh nhân 4 làn cho mỗi phép nhân 64 bit
+// của kernel CIOS vô hướng nên không được đưa vào.
+// Kết quả giống hệt modular_exponentiation vô hướng.
+class BatchModExp
+{
+public:
+    static const size_t LANES = 8; // 8 số 64 bit = 1 thanh ghi 512 bit
+
+private:
+    BigInt mod;
+    MontgomeryContext ctx;   // Đường vô hướng khi không có IFMA
+    size_t k;                // Số block 52 bit của p, R = 2^(52k)
+    uint64_t n0_inv;         // -p^-1 mod 2^52
+    LimbBuffer n;            // p, k block 52 bit, mỗi block lặp lại ở mọi làn (k * LANES)
+    LimbBuffer r2;           // R^2 mod p, xen kẽ theo làn (k * LANES)
+
+    // Kernel Montgomery trên LANES làn: out = a * b * R^-1 mod p (chỉ định nghĩa khi có IFMA)
+    // a, b, out: k * LANES phần tử; t: vùng nhớ tạm (k + 1) * LANES phần tử
+    void mul(const uint64_t *a, const uint64_t *b, uint64_t *out, uint64_t *t) const;
+
+public:
+    explicit BatchModExp(const BigInt &p);
+
+    // results[i] = bases[i]^exps[i] mod p (bases và exps cùng kích thước)
+    vector<BigInt> pow(const vector<BigInt> &bases, const vector<BigInt> &exps) const;
+
+    // Tên kernel được biên dịch: "avx512ifma" hoặc "scalar"
+    static const char *kernel_name();
+};
+
+// Thread pool cố định số luồng, chia việc theo chỉ số với cơ chế trộm việc (work stealing)
+// Mỗi luồng sở hữu 1 đoạn chunk liên tiếp, lấy chunk bằng fetch_add trên bộ đếm atomic của mình;
+// hết việc thì fetch_add trên bộ đếm của luồng khác --> không có khóa trên đường nóng.
+// Khóa chỉ dùng để phát và chờ 1 lần parallel_for.
+class WorkStealingPool
+{
+private:
+    struct alignas(64) Queue
+    {
+        atomic<size_t> next; // Chunk kế tiếp
+        size_t end;          // Hết đoạn của luồng
+    };
+
+    unsigned threads;                 // Số luồng tham gia, gồm cả luồng gọi parallel_for
+    vector<thread> workers;           // threads - 1 luồng nền
+    unique_ptr<Queue[]> queues;
+    mutex call_mutex;                 // Mỗi lúc chỉ 1 parallel_for
+    mutex m;
+    condition_variable cv_start, cv_done;
+    size_t generation = 0;            // Tăng mỗi lần phát việc
+    unsigned pending = 0;             // Số luồng nền chưa xong việc hiện tại
+    bool stopping = false;
+
+    const function<void(size_t, size_t)> *job = nullptr;
+    size_t job_n = 0, job_chunk = 1;
+    exception_ptr error;
+    mutex error_mutex;
+
+    void worker_loop(unsigned self);
+    void work(unsigned self);
+
+public:
+    // threads = 0: dùng thread::hardware_concurrency()
+    explicit WorkStealingPool(unsigned threads = 0);
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    unsigned size() const { return threads; }
+
+    // Gọi f(begin, end) cho mọi đoạn [i * chunk, min((i + 1) * chunk, n)), chờ tất cả xong
+    // Ngoại lệ đầu tiên phát sinh trong f được ném lại ở luồng gọi.
+    void parallel_for(size_t n, size_t chunk, const function<void(size_t, size_t)> &f);
 };
 
+// Trao đổi khóa hàng loạt trên cùng nhóm (p, g)
+// Dùng chung tiền xử lý theo modulus giữa mọi luồng:
+//  - FixedBaseTable của g cho khóa công khai g^x mod p
+//  - BatchModExp (MontgomeryContext bên trong) cho bí mật chung y^x mod p
+class KeyExchangeBatch
+{
+private:
+    BigInt p, g;
+    FixedBaseTable g_table;
+    BatchModExp peer_exp;
+    WorkStealingPool pool;
+    size_t chunk;
+
+public:
+    // threads = 0: mọi lõi; chunk: số phần tử mỗi lần lấy việc
+    KeyExchangeBatch(const BigInt &p, const BigInt &g, unsigned threads = 0, size_t chunk = 16);
+
+    // public_keys[i] = g^private_keys[i] mod p
+    vector<BigInt> public_keys(const vector<BigInt> &private_keys);
+
+    // secrets[i] = peer_public_keys[i]^private_keys[i] mod p
+    vector<BigInt> shared_secrets(const vector<BigInt> &private_keys, const vector<BigInt> &peer_public_keys);
+
+    unsigned threads() const { return pool.size(); }
+};
+
+// Kho số nguyên tố an toàn trên đĩa (nhóm tự sinh, không thuộc RFC)
+// File nhị phân có phiên bản, mỗi mục có checksum, khóa theo số bit:
+//  - Đầu file: FileHeader (magic "DHPRIME", version, count)
+//  - Mỗi mục: Record rồi 3 mảng k block 64 bit: p, R mod p, R^2 mod p (giống DHGroupParams)
+// Đọc: mmap chỉ đọc (MAP_SHARED) --> các process trên cùng máy dùng chung trang nhớ,
+// lấy tham số chỉ là kiểm tra checksum và trỏ vào vùng đã map.
+// Ghi: append() sinh số nguyên tố an toàn (chạy offline) rồi nối vào cuối file, khóa file trong lúc ghi.
+// File theo thứ tự byte của máy ghi (x86-64: little-endian).
+class PrimeStore
+{
+public:
+    static const uint32_t VERSION = 1;
+
+    // Một mục trong kho, các mảng trỏ thẳng vào vùng đã map (sống cùng PrimeStore)
+    struct Entry
+    {
+        uint32_t bits;
+        uint32_t limbs;      // k: số block 64 bit
+        uint64_t n0_inv;     // -p^-1 mod 2^64
+        uint64_t generator;
+        const uint64_t *p;
+        const uint64_t *r_mod;
+        const uint64_t *r2_mod;
+
+        BigInt prime() const { return BigInt::from_limbs64(p, limbs); }
+        // Dựng từ hằng số trong kho (chỉ sao chép, không chia)
+        MontgomeryContext context() const { return MontgomeryContext(p, limbs, n0_inv, r_mod, r2_mod); }
+    };
+
+private:
+    struct FileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t count;
+        uint64_t reserved[2];
+    };
+    struct Record
+    {
+        uint32_t bits;
+        uint32_t limbs;
+        uint64_t n0_inv;
+        uint64_t generator;
+        uint64_t checksum;   // FNV-1a 64 bit trên các trường trên và 3 mảng block
+    };
+
+    const unsigned char *base = nullptr;
+    size_t length = 0;
+    vector<Entry> entries;
+#if defined(_WIN32)
+    vector<unsigned char> buffer; // Không có mmap: đọc cả file vào bộ nhớ
+#endif
+
+    static uint64_t checksum(const Record &record, const uint64_t *limbs);
+
+public:
+    // Map file chỉ đọc và kiểm tra toàn bộ; file hỏng / sai phiên bản thì báo lỗi
+    explicit PrimeStore(const string &path);
+    ~PrimeStore();
+    PrimeStore(const PrimeStore &) = delete;
+    PrimeStore &operator=(const PrimeStore &) = delete;
+
+    // Mục đầu tiên có đúng bits bit, không có thì nullptr
+    const Entry *find(size_t bits) const;
+    const vector<Entry> &all() const { return entries; }
+
+    // Chế độ sinh: tạo số nguyên tố an toàn bits bit (song song) và nối vào file (tạo file nếu chưa có)
+    // Phần tử sinh g = 4 = 2^2: sinh nhóm con bậc q = (p - 1) / 2 với mọi số nguyên tố an toàn p
+    static void append(const string &path, int bits, unsigned threads = 0);
+    static void append(const string &path, const BigInt &p, uint64_t generator);
+};
+
+// Kho cặp khóa tạm thời (x, g^x mod p) dựng sẵn cho 1 nhóm (p, g)
+// Luồng nền (ưu tiên thấp) tính trước các cặp và đẩy vào hàng đợi vòng không khóa (nhiều ghi, nhiều đọc)
+// --> lúc bắt tay chỉ cần lấy 1 cặp, phép lũy thừa không nằm trên đường đi của kết nối.
+//  - Hàng đợi đạt high_watermark: luồng nền ngủ; tụt xuống low_watermark (available() <= low, low < high):
+//    luồng nền được đánh thức
+//  - Hàng đợi rỗng: pop() tự tính cặp mới ngay trên luồng gọi (đếm là miss)
+// Mỗi cặp chỉ được lấy ra 1 lần.
+class EphemeralKeyPool
+{
+public:
+    struct KeyPair
+    {
+        BigInt private_key; // x
+        BigInt public_key;  // g^x mod p
+    };
+
+    struct Stats
+    {
+        uint64_t hits;      // pop() lấy được cặp dựng sẵn
+        uint64_t misses;    // Hàng đợi rỗng, phải tính trên luồng gọi
+        uint64_t produced;  // Số cặp luồng nền đã tạo
+        double refill_rate; // Cặp / giây trên thời gian luồng nền thực sự tính
+        size_t available;   // Số cặp đang chờ
+    };
+
+private:
+    // Ô của hàng đợi: sequence cho biết ô đang trống (== vị trí ghi) hay đã có dữ liệu (== vị trí ghi + 1)
+    struct Slot
+    {
+        atomic<size_t> sequence;
+        KeyPair pair;
+    };
+
+    BigInt p;
+    FixedBaseTable g_table;
+    size_t low_watermark, high_watermark;
+    unique_ptr<Slot[]> slots;
+    size_t mask; // Dung lượng - 1 (dung lượng là lũy thừa của 2)
+    alignas(64) atomic<size_t> head{0}; // Vị trí đọc kế tiếp
+    alignas(64) atomic<size_t> tail{0}; // Vị trí ghi kế tiếp
+    alignas(64) atomic<uint64_t> hits{0};
+    atomic<uint64_t> misses{0}, produced{0}, busy_ns{0};
+    atomic<size_t> building{0}; // Số cặp luồng nền đang tạo (đã giữ chỗ, chưa đẩy vào hàng đợi)
+    atomic<bool> stopping{false};
+    mutex wake_mutex;
+    condition_variable wake;
+    vector<thread> workers;
+
+    KeyPair make_pair() const;
+    bool try_push(KeyPair &pair);
+    void refill_loop();
+
+public:
+    // capacity làm tròn lên lũy thừa của 2; high_watermark = 0: bằng capacity
+    // threads: số luồng nền nạp lại
+    EphemeralKeyPool(const BigInt &p, const BigInt &g, size_t capacity = 256, size_t low_watermark = 64,
+                     size_t high_watermark = 0, unsigned threads = 1);
+    // Dùng ngữ cảnh Montgomery có sẵn cho p (ví dụ DHGroup::context())
+    EphemeralKeyPool(const BigInt &g, const MontgomeryContext &ctx, size_t capacity = 256, size_t low_watermark = 64,
+                     size_t high_watermark = 0, unsigned threads = 1);
+    ~EphemeralKeyPool();
+    EphemeralKeyPool(const EphemeralKeyPool &) = delete;
+    EphemeralKeyPool &operator=(const EphemeralKeyPool &) = delete;
+
+    // Lấy 1 cặp; hàng đợi rỗng thì tính ngay (không bao giờ chờ luồng nền)
+    KeyPair pop();
+    // Chỉ lấy cặp dựng sẵn, false nếu hàng đợi rỗng
+    bool try_pop(KeyPair &out);
+    size_t available() const;
+    Stats stats() const;
+};
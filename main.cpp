@@ -1,11 +1,11 @@
 #include <iostream>
 #include "diffie_hellman.h"
-#include "diffie_hellman.cpp"
+#include "dh_groups.h"
 using namespace std;
 
 int main(int argc, char **argv)
 {
-    // Kiểm tra tham số dòng lệnh
+    // Kiểm tra tham số dòng lệnh: main [bit_size] [file kho số nguyên tố]
     int bit_size;
     if (argc < 2)
         bit_size = 512; // Mặc định 512 bits
@@ -13,18 +13,66 @@ int main(int argc, char **argv)
         bit_size = atoi(argv[1]);
 
     // Thiết lập các tham số ban đầu:
-    //      Lấy số nguyên tố an toàn p
-    //      Phần tử sinh g = 5
-    BigInt p = BigInt::generate_safe_prime(bit_size);
-    BigInt g = 5;
+    //      Có nhóm MODP (RFC 3526) đúng bit_size: dùng p, g = 2 dựng sẵn (không sinh số nguyên tố)
+    //      Có file kho (PrimeStore): lấy p, g từ kho; kho chưa có bit_size thì sinh và ghi thêm vào kho
+    //      Ngược lại: tìm số nguyên tố an toàn p song song trên mọi core, phần tử sinh g = 4
+    //      (g = 4 = 2^2 là thặng dư bậc hai --> sinh nhóm con cấp q, giống PrimeStore)
+    const DHGroup *group = DHGroup::by_bits(bit_size);
+    BigInt p, g;
+    if (group)
+    {
+        p = group->prime();
+        g = group->generator();
+    }
+    else if (argc >= 3)
+    {
+        unique_ptr<PrimeStore> store;
+        try
+        {
+            store.reset(new PrimeStore(argv[2]));
+        }
+        catch (const runtime_error &)
+        {
+            // Chưa có file: tạo mới ở bước append
+        }
+        if (!store || !store->find(bit_size))
+        {
+            PrimeStore::append(argv[2], bit_size);
+            store.reset(new PrimeStore(argv[2]));
+        }
+        const PrimeStore::Entry *entry = store->find(bit_size);
+        p = entry->prime();
+        g = entry->generator;
+    }
+    else
+    {
+        p = BigInt::generate_safe_prime_parallel(bit_size);
+        g = 4;
+    }
 
     // Sinh khóa riêng cho Alice và Bob
     BigInt a = BigInt::generate_private_key(p);
     BigInt b = BigInt::generate_private_key(p);
 
-    // Tính khóa bí mật chung
-    BigInt alice_shared_secret = BigInt::modular_exponentiation(g, a, p);
-    BigInt bob_shared_secret = BigInt::modular_exponentiation(g, b, p);
+    // Tính khóa công khai A = g^a, B = g^b
+    // Bảng lũy thừa của g dựng 1 lần cho cặp (g, p), dùng lại cho mọi khóa
+    FixedBaseTable g_table = group ? FixedBaseTable(g, group->context()) : FixedBaseTable(g, p);
+    BigInt alice_public_key = g_table.pow_consttime(a);
+    BigInt bob_public_key = g_table.pow_consttime(b);
+
+    // Mỗi bên kiểm tra khóa công khai nhận được trước khi dùng
+    // (nằm trong khoảng (1, p - 1) và thuộc nhóm con cấp q)
+    vector<bool> valid = BigInt::validate_public_key_batch({alice_public_key, bob_public_key}, p);
+    if (!valid[0] || !valid[1])
+    {
+        cout << "Invalid public key [!]" << endl;
+        return 1;
+    }
+
+    // Tính khóa bí mật chung: Alice B^a, Bob A^b (cùng bằng g^(ab))
+    // Số mũ là khóa riêng --> dùng bản thời gian hằng
+    BigInt alice_shared_secret = BigInt::modular_exponentiation_consttime(bob_public_key, a, g_table.context());
+    BigInt bob_shared_secret = BigInt::modular_exponentiation_consttime(alice_public_key, b, g_table.context());
 
     // In ra kết quả
     cout << "The shared secret that Alice claims: " << alice_shared_secret << endl;
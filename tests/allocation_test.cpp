@@ -0,0 +1,60 @@
+#include <cstdio>
+#include <functional>
+#include "diffie_hellman.h"
+#include "alloc_counter.h"
+using namespace std;
+
+// Giới hạn số lần cấp phát heap cho mỗi lần gọi các đường nóng
+// (toán tử gộp, vùng nhớ arena, chuyển đổi chuỗi chia để trị).
+// Đếm bằng operator new thay thế của bench/alloc_counter.cpp; mỗi phép được chạy thử 1 lần trước
+// (bảng lũy thừa 10^k, arena của thread) rồi lấy trung bình trên nhiều lần gọi.
+// Số liệu trước khi có toán tử gộp (user-015): parse 1181, print 590 lần / số 2048 bit.
+
+static int failures = 0;
+static volatile size_t sink;
+
+static void expect_allocs(const char *name, double limit, const function<void()> &op)
+{
+    const int CALLS = 20;
+    op();
+    uint64_t before = heap_allocations();
+    for (int i = 0; i < CALLS; i++)
+        op();
+    double per_call = (double)(heap_allocations() - before) / CALLS;
+    bool ok = per_call <= limit;
+    printf("%-4s %-28s %8.2f allocs/call (limit %.0f)\n", ok ? "ok" : "FAIL", name, per_call, limit);
+    if (!ok)
+        failures++;
+}
+
+int main()
+{
+    BigInt::seed_random(15);
+    BigInt a = BigInt::random_bits(2048), b = BigInt::random_bits(2048), c = BigInt::random_bits(4000);
+    BigInt prime = BigInt::generate_prime(1024);
+    BigInt even_mod = BigInt::random_bits(1024) + 1; // random_bits luôn lẻ --> +1 là số chẵn
+    BigInt exp = BigInt::random_bits(1024);
+    string dec = a.to_string();
+
+    // Kết quả chiếm 1 vùng heap; số tạm nằm trong arena
+    expect_allocs("decimal parse (2048 bit)", 1, [&]
+                  { sink = BigInt(dec).bit_length(); });
+    expect_allocs("decimal print (2048 bit)", 1, [&]
+                  { sink = a.to_string().size(); });
+    // Mọi số tạm (Montgomery, cơ số ngẫu nhiên) nằm trong arena
+    expect_allocs("is_prime_by_Miller_Rabin", 0, [&]
+                  { sink = BigInt::is_prime_by_Miller_Rabin(prime); });
+    // Modulus chẵn: đường Barrett, chỉ kết quả được tách ra heap
+    expect_allocs("modexp, even modulus", 1, [&]
+                  { sink = BigInt::modular_exponentiation(a, exp, even_mod).bit_length(); });
+    // a * b tạo 1 số tạm, + c dùng lại vùng nhớ của số tạm đó (toán tử rvalue)
+    expect_allocs("a * b + c", 1, [&]
+                  { sink = (a * b + c).bit_length(); });
+
+    if (failures)
+    {
+        printf("%d allocation bounds exceeded\n", failures);
+        return 1;
+    }
+    return 0;
+}
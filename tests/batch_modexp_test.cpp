@@ -0,0 +1,74 @@
+#include <cstdio>
+#include "diffie_hellman.h"
+#include "dh_groups.h"
+using namespace std;
+
+// Kiểm tra BatchModExp::pow khớp modular_exponentiation trên từng làn
+// Bản dựng DH_NATIVE=ON trên máy có AVX-512 IFMA chạy kernel "avx512ifma", ngược lại "scalar";
+// cả 2 đều phải cho kết quả giống hệt phép lũy thừa vô hướng.
+// Đầu vào gồm các trường hợp biên: số mũ 0, cơ số 0, p, p - 1, cơ số / số mũ lớn hơn p,
+// số phần tử không chia hết cho LANES (nhóm cuối có làn trống).
+
+static int failures = 0;
+
+static void check_modulus(const char *label, const BigInt &p)
+{
+    vector<BigInt> bases, exps;
+    vector<BigInt> edge_bases = {BigInt(0), BigInt(1), p - 1, p, p + 1, BigInt(2)};
+    vector<BigInt> edge_exps = {BigInt(0), BigInt(1), BigInt(2), p - 1, p * 3, BigInt(0)};
+    for (size_t i = 0; i < edge_bases.size(); i++)
+    {
+        for (size_t j = 0; j < edge_exps.size(); j++)
+        {
+            bases.push_back(edge_bases[i]);
+            exps.push_back(edge_exps[j]);
+        }
+    }
+    // Cơ số / số mũ ngẫu nhiên với độ dài khác nhau giữa các làn
+    for (size_t i = 0; i < 3 * BatchModExp::LANES + 5; i++)
+    {
+        bases.push_back(BigInt::random_bits((int)p.bit_length() + (int)(i % 3) - 1));
+        exps.push_back(BigInt::random_bits(1 + (int)((i * 37) % p.bit_length())));
+    }
+
+    BatchModExp batch(p);
+    vector<BigInt> results = batch.pow(bases, exps);
+    if (results.size() != bases.size())
+    {
+        printf("FAIL %s: %zu results for %zu inputs\n", label, results.size(), bases.size());
+        failures++;
+        return;
+    }
+    for (size_t i = 0; i < bases.size(); i++)
+    {
+        BigInt expected = BigInt::modular_exponentiation(bases[i], exps[i], p);
+        if (!(results[i] == expected))
+        {
+            printf("FAIL %s lane %zu: base %s exp %s\n", label, i % BatchModExp::LANES,
+                   bases[i].to_hex_string().c_str(), exps[i].to_hex_string().c_str());
+            failures++;
+        }
+    }
+}
+
+int main()
+{
+    printf("BatchModExp kernel: %s\n", BatchModExp::kernel_name());
+    BigInt::seed_random(11);
+    for (int bits : {61, 127, 521, 1024})
+    {
+        char label[32];
+        snprintf(label, sizeof(label), "prime%d", bits);
+        check_modulus(label, BigInt::generate_prime(bits));
+    }
+    for (const char *name : {"modp2048", "ffdhe3072"})
+        check_modulus(name, DHGroup::find(name)->prime());
+
+    if (failures)
+    {
+        printf("%d mismatches\n", failures);
+        return 1;
+    }
+    puts("OK");
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include <cstdio>
+#include "diffie_hellman.h"
+#include "dh_groups.h"
+using namespace std;
+
+// Kiểm tra FixedBaseTable::pow và pow_consttime khớp modular_exponentiation
+// Bảng với nhiều độ rộng cửa sổ và độ dài số mũ (exp_bits không chia hết cho 64 hoặc cho w);
+// số mũ gồm các trường hợp biên: 0, 1, p - 1, toàn bit 1 vừa đủ bảng, dài hơn bảng (đường dự phòng).
+
+static int failures = 0;
+
+static void check_table(const char *label, const BigInt &g, const BigInt &p, int window, size_t exp_bits)
+{
+    FixedBaseTable table(g, p, window, exp_bits);
+    size_t bits = exp_bits ? exp_bits : p.bit_length();
+    vector<BigInt> exps = {BigInt(0), BigInt(1), BigInt(2), p - 1, (BigInt(1) << (int)bits) - 1,
+                           BigInt(1) << (int)(bits - 1), (BigInt(1) << (int)(bits + 64)) + 3,
+                           BigInt::random_bits((int)bits + 130)};
+    for (int i = 0; i < 12; i++)
+        exps.push_back(BigInt::random_bits(1 + (i * 97) % (int)bits));
+
+    for (const BigInt &exp : exps)
+    {
+        BigInt expected = BigInt::modular_exponentiation(g, exp, p);
+        if (!(table.pow(exp) == expected))
+        {
+            printf("FAIL %s w=%d pow: exp %s\n", label, window, exp.to_hex_string().c_str());
+            failures++;
+        }
+        if (!(table.pow_consttime(exp) == expected))
+        {
+            printf("FAIL %s w=%d pow_consttime: exp %s\n", label, window, exp.to_hex_string().c_str());
+            failures++;
+        }
+    }
+}
+
+int main()
+{
+    BigInt::seed_random(23);
+    BigInt p = BigInt::generate_prime(521);
+    for (int w : {1, 4, 5, 7})
+    {
+        check_table("prime521", BigInt(4), p, w, 0);
+        check_table("prime521/200", BigInt(4), p, w, 200);
+    }
+    const DHGroup *group = DHGroup::find("modp2048");
+    check_table("modp2048", group->generator(), group->prime(), 4, 0);
+
+    if (failures)
+    {
+        printf("%d mismatches\n", failures);
+        return 1;
+    }
+    puts("OK");
+    return 0;
+}
@@ -0,0 +1,349 @@
+#include <cstdio>
+#include "diffie_hellman.h"
+using namespace std;
+
+// Kiểm tra is_prime_by_Baillie_PSW trên bộ số giả nguyên tố đã biết
+// is_prime_by_Baillie_PSW chia thử cho số nguyên tố < 1000 và trả về luôn với n < 10^6, nên chỉ hợp số
+// >= 10^6 không có ước < 1000 mới đi tới 2 bước xác suất; bộ số chia làm 2 phần:
+//  - *_TRIAL: có ước < 1000, bị loại ngay ở bước chia thử (giữ lại để chống hồi quy)
+//  - *_PAST_TRIAL: qua được bước chia thử (test tự kiểm tra điều này), nên:
+//      số giả nguyên tố mạnh cơ số 2 (OEIS A001262) qua vòng Miller-Rabin cơ số 2 --> phải bị loại ở bước Lucas
+//      số giả nguyên tố Lucas mạnh (OEIS A217255, tham số Selfridge) qua bước Lucas (kiểm tra bằng
+//      is_strong_lucas_probable_prime bên dưới) --> phải bị loại ở vòng Miller-Rabin cơ số 2
+//  - Bình phương số nguyên tố (1093^2, 3511^2 là số Wieferich --> giả nguyên tố cơ số 2)
+//  - Các khoảng mà kết quả phải khớp với phép chia thử
+//  - generate_prime / generate_safe_prime với PrimalityTest::BAILLIE_PSW
+// Mỗi hợp số đi kèm 1 ước thật sự --> test tự chứng minh đó là hợp số, không tin vào bảng.
+
+static int failures = 0;
+
+struct Composite
+{
+    const char *n;
+    const char *factor;
+};
+
+// A001262, kèm ước nhỏ nhất
+static const Composite STRONG_BASE2_TRIAL[] = {
+    {"2047", "23"},
+    {"3277", "29"},
+    {"4033", "37"},
+    {"4681", "31"},
+    {"8321", "53"},
+    {"1004653", "13"},
+    {"1016801", "251"},
+    {"1023121", "11"},
+    {"1082401", "601"},
+    {"1145257", "103"},
+    {"1207361", "449"},
+    {"1251949", "409"},
+    {"3215031751", "151"},
+};
+static const Composite STRONG_BASE2_PAST_TRIAL[] = {
+    {"1194649", "1093"},
+    {"12327121", "3511"},
+    {"2152302898747", "6763"},
+    {"3474749660383", "1303"},
+    {"341550071728321", "10670053"},
+    {"3825123056546413051", "149491"},
+    {"318665857834031151167461", "399165290221"},
+    {"3317044064679887385961981", "1287836182261"},
+};
+
+// A217255, kèm ước nhỏ nhất
+static const Composite STRONG_LUCAS_TRIAL[] = {
+    {"5459", "53"},
+    {"5777", "53"},
+    {"10877", "73"},
+    {"16109", "89"},
+    {"18971", "61"},
+    {"22499", "149"},
+    {"24569", "79"},
+    {"25199", "113"},
+    {"40309", "173"},
+    {"58519", "139"},
+    {"75077", "193"},
+    {"97439", "139"},
+    {"100127", "223"},
+    {"113573", "137"},
+    {"115639", "197"},
+    {"130139", "181"},
+    {"1033997", "293"},
+    {"1106327", "743"},
+    {"1241099", "19"},
+    {"1256293", "457"},
+    {"1308119", "661"},
+    {"1311389", "809"},
+    {"1388903", "263"},
+    {"1422319", "229"},
+    {"1501439", "409"},
+    {"1697183", "769"},
+};
+// Các số đầu tiên của A217255 không có ước < 1000 (mọi ước nguyên tố > 1000)
+static const Composite STRONG_LUCAS_PAST_TRIAL[] = {
+    {"1711469", "1069"},
+    {"2263127", "1063"},
+    {"2518889", "1123"},
+    {"2624399", "1619"},
+    {"2662277", "1153"},
+    {"2666711", "1381"},
+    {"2738969", "1171"},
+    {"3399527", "1303"},
+    {"3694079", "1109"},
+    {"3700559", "1361"},
+    {"3774377", "1373"},
+    {"3802499", "1949"},
+    {"3813011", "1009"},
+    {"3903791", "1669"},
+    {"4226777", "1453"},
+    {"4403027", "1483"},
+    {"4828277", "1553"},
+    {"4870847", "1087"},
+    {"5208377", "1613"},
+    {"5299139", "1627"},
+    {"5450201", "2089"},
+    {"5479109", "1171"},
+    {"5720219", "1069"},
+    {"5942627", "1723"},
+    {"6001379", "1733"},
+    {"6296291", "1619"},
+    {"6641189", "1823"},
+    {"6965639", "1319"},
+    {"7199399", "2399"},
+    {"7241639", "1553"},
+    {"7453619", "2063"},
+};
+
+static void expect(bool ok, const char *what, const string &n)
+{
+    if (!ok)
+    {
+        printf("FAIL %s: %s\n", what, n.c_str());
+        failures++;
+    }
+}
+
+// Miller-Rabin cơ số 2 viết lại bằng API công khai: n - 1 = 2^s * d, xét dãy 2^d, 2^(2d), ...
+static bool is_strong_probable_prime_base2(const BigInt &n)
+{
+    BigInt n_minus_1 = n - 1, d = n_minus_1;
+    int s = 0;
+    while (!d.bit(0))
+    {
+        d >>= 1;
+        s++;
+    }
+    BigInt x = BigInt::modular_exponentiation(BigInt(2), d, n);
+    if (x == 1 || x == n_minus_1)
+        return true;
+    for (int i = 1; i < s; i++)
+    {
+        x = BigInt::mod_mul(x, x, n);
+        if (x == n_minus_1)
+            return true;
+    }
+    return false;
+}
+
+// Lucas mạnh với tham số Selfridge (P = 1, Q = (1 - D) / 4) viết lại bằng API công khai,
+// độc lập với bản trong thư viện: n + 1 = 2^s * d, n là số giả nguyên tố Lucas mạnh khi
+// U_d = 0, V_d = 0 hoặc V_(d * 2^r) = 0 với 0 < r < s
+static BigInt isqrt(const BigInt &n)
+{
+    if (n.is_zero())
+        return n;
+    BigInt x = BigInt(1) << (int)((n.bit_length() + 1) / 2);
+    while (true)
+    {
+        BigInt y = (x + n / x) >> 1;
+        if (!(y < x))
+            return x;
+        x = y;
+    }
+}
+
+// (a - b) mod n và x / 2 mod n (a, b, x < n, n lẻ)
+static BigInt sub_mod(const BigInt &a, const BigInt &b, const BigInt &n)
+{
+    return a >= b ? a - b : a + n - b;
+}
+
+static BigInt half_mod(const BigInt &x, const BigInt &n)
+{
+    return x.bit(0) ? (x + n) >> 1 : x >> 1;
+}
+
+// Giá trị âm -v biểu diễn bằng n - v mod n
+static BigInt signed_mod(int64_t v, const BigInt &n)
+{
+    BigInt r = BigInt((uint64_t)(v < 0 ? -v : v)) % n;
+    return v >= 0 || r.is_zero() ? r : n - r;
+}
+
+static bool is_strong_lucas_probable_prime(const BigInt &n)
+{
+    BigInt root = isqrt(n);
+    if (root * root == n)
+        return false; // Số chính phương: không tồn tại D với (D / n) = -1
+    int64_t D = 5;
+    BigInt d_mod;
+    while (true)
+    {
+        d_mod = signed_mod(D, n);
+        int j = BigInt::jacobi(d_mod, n);
+        if (j == -1)
+            break;
+        if (j == 0 && !(BigInt((uint64_t)(D < 0 ? -D : D)) == n))
+            return false;
+        D = D > 0 ? -(D + 2) : -D + 2;
+    }
+    BigInt q_mod = signed_mod((1 - D) / 4, n);
+    BigInt d = n + 1;
+    int s = 0;
+    while (!d.bit(0))
+    {
+        d >>= 1;
+        s++;
+    }
+
+    // U_1 = 1, V_1 = P = 1; nhân đôi: U_2k = U_k V_k, V_2k = V_k^2 - 2Q^k;
+    // cộng 1: U_(k+1) = (U + V) / 2, V_(k+1) = (D U + V) / 2
+    BigInt U(1), V(1), Qk = q_mod;
+    for (size_t i = d.bit_length() - 1; i-- > 0;)
+    {
+        U = BigInt::mod_mul(U, V, n);
+        V = sub_mod(BigInt::mod_mul(V, V, n), (Qk + Qk) % n, n);
+        Qk = BigInt::mod_mul(Qk, Qk, n);
+        if (d.bit(i))
+        {
+            BigInt next_u = half_mod((U + V) % n, n);
+            V = half_mod((BigInt::mod_mul(d_mod, U, n) + V) % n, n);
+            U = next_u;
+            Qk = BigInt::mod_mul(Qk, q_mod, n);
+        }
+    }
+    if (U.is_zero() || V.is_zero())
+        return true;
+    for (int r = 1; r < s; r++)
+    {
+        V = sub_mod(BigInt::mod_mul(V, V, n), (Qk + Qk) % n, n);
+        Qk = BigInt::mod_mul(Qk, Qk, n);
+        if (V.is_zero())
+            return true;
+    }
+    return false;
+}
+
+static bool is_prime_by_trial_division(uint64_t n)
+{
+    if (n < 2)
+        return false;
+    for (uint64_t p = 2; p * p <= n; p++)
+        if (n % p == 0)
+            return false;
+    return true;
+}
+
+// n đi tới bước Miller-Rabin / Lucas của is_prime_by_Baillie_PSW: n >= 10^6 và không có ước < 1000
+static bool survives_trial_division(const BigInt &n)
+{
+    if (n < 1000000)
+        return false;
+    for (uint32_t p = 2; p < 1000; p++)
+        if (n.mod_small(p) == 0)
+            return false;
+    return true;
+}
+
+// factor là ước thật sự của n (1 < factor < n) --> n là hợp số
+static bool has_proper_factor(const BigInt &n, const BigInt &factor)
+{
+    return factor > 1 && factor < n && (n % factor).is_zero();
+}
+
+enum class Pseudoprime
+{
+    BASE2, // Qua vòng Miller-Rabin cơ số 2
+    LUCAS  // Qua bước Lucas mạnh
+};
+
+template <size_t N>
+static void check_corpus(const char *label, const Composite (&corpus)[N], Pseudoprime kind, bool past_trial)
+{
+    for (size_t i = 0; i < N; i++)
+    {
+        BigInt n(corpus[i].n), factor(corpus[i].factor);
+        string name = string(label) + " " + corpus[i].n;
+        expect(has_proper_factor(n, factor), "not composite", name);
+        expect(survives_trial_division(n) == past_trial,
+               past_trial ? "caught by trial division" : "not caught by trial division", name);
+        bool base2 = is_strong_probable_prime_base2(n), lucas = is_strong_lucas_probable_prime(n);
+        if (kind == Pseudoprime::BASE2)
+            expect(base2, "not a base-2 strong pseudoprime", name);
+        else
+            expect(lucas, "not a strong Lucas pseudoprime", name);
+        // Qua được chia thử: chỉ bước còn lại loại được n
+        if (past_trial)
+            expect(!(base2 && lucas), "passes both probable-prime steps", name);
+        expect(!BigInt::is_prime_by_Baillie_PSW(n), "accepted pseudoprime", name);
+    }
+}
+
+static void check_range(uint64_t from, uint64_t to)
+{
+    for (uint64_t n = from; n < to; n++)
+    {
+        if (BigInt::is_prime_by_Baillie_PSW(BigInt(n)) != is_prime_by_trial_division(n))
+            expect(false, "disagrees with trial division", to_string(n));
+    }
+}
+
+int main()
+{
+    BigInt::seed_random(25);
+    check_corpus("spsp(2)", STRONG_BASE2_TRIAL, Pseudoprime::BASE2, false);
+    check_corpus("spsp(2)", STRONG_BASE2_PAST_TRIAL, Pseudoprime::BASE2, true);
+    check_corpus("slpsp", STRONG_LUCAS_TRIAL, Pseudoprime::LUCAS, false);
+    check_corpus("slpsp", STRONG_LUCAS_PAST_TRIAL, Pseudoprime::LUCAS, true);
+
+    // Bình phương số nguyên tố: số Wieferich và số nguyên tố lớn
+    for (uint64_t p : {1093ULL, 3511ULL, 65521ULL, 4294967291ULL})
+        expect(!BigInt::is_prime_by_Baillie_PSW(BigInt(p) * BigInt(p)), "accepted square", to_string(p) + "^2");
+    for (int bits : {64, 256, 1024})
+    {
+        BigInt p = BigInt::generate_prime(bits);
+        expect(!BigInt::is_prime_by_Baillie_PSW(p * p), "accepted square", p.to_string() + "^2");
+    }
+
+    // Quanh ngưỡng chia thử (10^6) và quanh 2^32
+    check_range(0, 30000);
+    check_range(999000, 1100000);
+    check_range((1ULL << 32) - 5000, (1ULL << 32) + 5000);
+
+    // Số Mersenne: 2^61-1, 2^89-1, 2^127-1, 2^521-1 nguyên tố; 2^67-1, 2^257-1 hợp số
+    for (int e : {61, 89, 127, 521})
+    {
+        BigInt m = (BigInt(1) << e) - 1;
+        expect(BigInt::is_prime_by_Baillie_PSW(m), "rejected Mersenne prime", "2^" + to_string(e) + "-1");
+        expect(is_strong_probable_prime_base2(m) && is_strong_lucas_probable_prime(m), "reference tests reject a prime",
+               "2^" + to_string(e) + "-1");
+    }
+    expect(!BigInt::is_prime_by_Baillie_PSW((BigInt(1) << 67) - 1), "accepted composite", "2^67-1");
+    expect(!BigInt::is_prime_by_Baillie_PSW((BigInt(1) << 257) - 1), "accepted composite", "2^257-1");
+
+    // Sinh số nguyên tố bằng BPSW, đối chiếu với Miller-Rabin 40 vòng
+    BigInt p = BigInt::generate_prime(256, PrimalityTest::BAILLIE_PSW);
+    expect(p.bit_length() == 256 && BigInt::is_prime_by_Miller_Rabin(p, 40), "generate_prime", p.to_string());
+    BigInt q = BigInt::generate_safe_prime(256, PrimalityTest::BAILLIE_PSW);
+    expect(q.bit_length() == 256 && BigInt::is_prime_by_Miller_Rabin(q, 40) &&
+               BigInt::is_prime_by_Miller_Rabin((q - 1) >> 1, 40),
+           "generate_safe_prime", q.to_string());
+
+    if (failures)
+    {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    puts("OK");
+    return 0;
+}
@@ -0,0 +1,186 @@
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "diffie_hellman.h"
+using namespace std;
+
+// Kiểm tra PrimeStore trên file tạm với số nguyên tố an toàn nhỏ (128 - 192 bit)
+//  - append rồi mở lại: đúng số mục, đúng p, generator và hằng số Montgomery
+//  - append thêm vào file đã có, mở lại: các mục cũ giữ nguyên
+//  - File hỏng bị từ chối: lật từng byte của mục đầu, cắt cụt, sai magic / version, file quá nhỏ
+// Bố cục file (diffie_hellman.h): FileHeader 32 byte, mỗi mục Record 32 byte + 3 * k block 64 bit.
+
+static int failures = 0;
+static const size_t HEADER_BYTES = 32, RECORD_BYTES = 32;
+
+static void expect(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        printf("FAIL %s\n", what);
+        failures++;
+    }
+}
+
+static vector<char> read_file(const string &path)
+{
+    ifstream in(path, ios::binary);
+    return vector<char>(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+static void write_file(const string &path, const vector<char> &bytes)
+{
+    ofstream out(path, ios::binary | ios::trunc);
+    out.write(bytes.data(), (streamsize)bytes.size());
+}
+
+// Mở path phải ném runtime_error có chứa message
+static bool rejects(const string &path, const char *message)
+{
+    try
+    {
+        PrimeStore store(path);
+    }
+    catch (const runtime_error &e)
+    {
+        return strstr(e.what(), message) != nullptr;
+    }
+    return false;
+}
+
+static void expect_rejected(const char *what, const string &path, const vector<char> &bytes, const char *message)
+{
+    write_file(path, bytes);
+    expect(rejects(path, message), what);
+}
+
+// Ngữ cảnh dựng từ kho phải cho cùng kết quả với ngữ cảnh tính lại từ p
+static bool entry_matches(const PrimeStore::Entry *entry, const BigInt &p, uint64_t generator)
+{
+    if (!entry || !(entry->prime() == p) || entry->generator != generator || entry->bits != p.bit_length())
+        return false;
+    BigInt x = BigInt::random_bits((int)p.bit_length() - 1);
+    return BigInt::modular_exponentiation(BigInt(generator), x, entry->context()) ==
+           BigInt::modular_exponentiation(BigInt(generator), x, p);
+}
+
+int main()
+{
+    BigInt::seed_random(19);
+    string dir = filesystem::temp_directory_path().string();
+    string tag = BigInt::random_bits(32).to_hex_string();
+    string path = dir + "/prime_store_test_" + tag + ".bin";
+    string bad = dir + "/prime_store_test_" + tag + "_bad.bin";
+    filesystem::remove(path);
+
+    // Chế độ sinh tạo file mới
+    PrimeStore::append(path, 128, 1);
+    BigInt p192 = BigInt::generate_safe_prime(192);
+    PrimeStore::append(path, p192, 2);
+    BigInt p128;
+    {
+        PrimeStore store(path);
+        expect(store.all().size() == 2, "two entries after two appends");
+        const PrimeStore::Entry *e128 = store.find(128);
+        expect(e128 && e128->limbs == 2, "128-bit entry");
+        if (e128)
+        {
+            p128 = e128->prime();
+            expect(BigInt::is_prime_by_Miller_Rabin(p128, 40) && BigInt::is_prime_by_Miller_Rabin((p128 - 1) >> 1, 40),
+                   "stored 128-bit prime is a safe prime");
+            expect(entry_matches(e128, p128, 4), "128-bit entry round-trip");
+        }
+        expect(entry_matches(store.find(192), p192, 2), "192-bit entry round-trip");
+        expect(store.find(256) == nullptr, "find of a missing size");
+    }
+
+    // Nối vào file đã có rồi mở lại
+    BigInt p160 = BigInt::generate_safe_prime(160);
+    PrimeStore::append(path, p160, 5);
+    {
+        PrimeStore store(path);
+        expect(store.all().size() == 3, "three entries after reopen");
+        expect(entry_matches(store.find(128), p128, 4) && entry_matches(store.find(192), p192, 2) &&
+                   entry_matches(store.find(160), p160, 5),
+               "entries survive append and reopen");
+    }
+
+    vector<char> good = read_file(path);
+    // Lật từng byte của mục đầu tiên (Record + 3 mảng block): checksum / kích thước phải bắt được
+    size_t entry_bytes = RECORD_BYTES + 3 * 2 * sizeof(uint64_t);
+    int accepted = 0;
+    for (size_t i = HEADER_BYTES; i < HEADER_BYTES + entry_bytes; i++)
+    {
+        vector<char> bytes = good;
+        bytes[i] ^= 0x01;
+        write_file(bad, bytes);
+        try
+        {
+            PrimeStore store(bad);
+            accepted++;
+        }
+        catch (const runtime_error &)
+        {
+        }
+    }
+    expect(accepted == 0, "every flipped byte of an entry is rejected");
+
+    vector<char> bytes = good;
+    bytes[HEADER_BYTES + RECORD_BYTES + 3] ^= 0x80;
+    expect_rejected("flipped limb byte", bad, bytes, "checksum mismatch");
+    bytes = good;
+    bytes[HEADER_BYTES + 8] ^= 0x10; // generator
+    expect_rejected("flipped generator byte", bad, bytes, "checksum mismatch");
+
+    bytes = good;
+    bytes.resize(good.size() - 8);
+    expect_rejected("last entry cut short", bad, bytes, "truncated entry");
+    bytes.resize(HEADER_BYTES + 4);
+    expect_rejected("record cut short", bad, bytes, "truncated entry");
+    bytes.resize(10);
+    expect_rejected("file shorter than the header", bad, bytes, "file too small");
+
+    bytes = good;
+    bytes[0] = 'X';
+    expect_rejected("bad magic", bad, bytes, "bad magic");
+    try
+    {
+        PrimeStore::append(bad, p192, 2);
+        expect(false, "append to a file with bad magic");
+    }
+    catch (const runtime_error &e)
+    {
+        expect(strstr(e.what(), "cannot append to") != nullptr, "append to a file with bad magic");
+    }
+    bytes = good;
+    bytes[8] ^= 0x02; // version
+    expect_rejected("unsupported version", bad, bytes, "unsupported version");
+
+    filesystem::remove(bad);
+    expect(rejects(bad, "cannot open"), "missing file");
+
+    // Mục ghi dở (count chưa tăng) không được đọc tới
+    bytes = good;
+    bytes.insert(bytes.end(), 17, '\x5A');
+    write_file(bad, bytes);
+    try
+    {
+        PrimeStore store(bad);
+        expect(store.all().size() == 3, "trailing partial entry is ignored");
+    }
+    catch (const runtime_error &)
+    {
+        expect(false, "trailing partial entry is ignored");
+    }
+
+    filesystem::remove(path);
+    filesystem::remove(bad);
+    if (failures)
+    {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    puts("OK");
+    return 0;
+}